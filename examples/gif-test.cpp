@@ -18,9 +18,11 @@ void printUsage(const char* prog) {
   std::cerr << "Usage: " << prog << " [options] <gif_file.gif>" << std::endl;
   std::cerr << "\nOptions:" << std::endl;
   std::cerr << "  --fullscreen, -f   Use optimized full-screen mode (default)" << std::endl;
+  std::cerr << "  --grid, -g         Use grid mode (one animation, only changed keys sent)" << std::endl;
   std::cerr << "  --per-key, -k      Use per-key mode (9 separate animations)" << std::endl;
   std::cerr << "\nExample:" << std::endl;
   std::cerr << "  " << prog << " animation.gif" << std::endl;
+  std::cerr << "  " << prog << " --grid animation.gif" << std::endl;
   std::cerr << "  " << prog << " --per-key animation.gif" << std::endl;
 }
 
@@ -30,15 +32,18 @@ int main(int argc, char *argv[]) {
     return 1;
   }
 
-  bool fullscreen_mode = true;  // Default to optimized full-screen mode
+  enum class Mode { FULLSCREEN, GRID, PER_KEY };
+  Mode mode = Mode::FULLSCREEN;  // Default to optimized full-screen mode
   std::string gif_path;
 
   // Parse arguments
   for (int i = 1; i < argc; i++) {
     if (strcmp(argv[i], "--fullscreen") == 0 || strcmp(argv[i], "-f") == 0) {
-      fullscreen_mode = true;
+      mode = Mode::FULLSCREEN;
+    } else if (strcmp(argv[i], "--grid") == 0 || strcmp(argv[i], "-g") == 0) {
+      mode = Mode::GRID;
     } else if (strcmp(argv[i], "--per-key") == 0 || strcmp(argv[i], "-k") == 0) {
-      fullscreen_mode = false;
+      mode = Mode::PER_KEY;
     } else if (argv[i][0] != '-') {
       gif_path = argv[i];
     } else {
@@ -58,7 +63,11 @@ int main(int argc, char *argv[]) {
   std::cout << "LogiLinux GIF Animation Test v" << version.major << "."
             << version.minor << "." << version.patch << std::endl;
   std::cout << "Testing GIF: " << gif_path << std::endl;
-  std::cout << "Mode: " << (fullscreen_mode ? "Full-screen (optimized)" : "Per-key (9 animations)") << "\n" << std::endl;
+  std::cout << "Mode: "
+            << (mode == Mode::FULLSCREEN ? "Full-screen (optimized)"
+                : mode == Mode::GRID     ? "Grid (changed keys only)"
+                                         : "Per-key (9 animations)")
+            << "\n" << std::endl;
 
   signal(SIGINT, signalHandler);
 
@@ -102,7 +111,7 @@ int main(int argc, char *argv[]) {
 
   std::cout << "Device initialized!" << std::endl;
 
-  if (fullscreen_mode) {
+  if (mode == Mode::FULLSCREEN) {
     // Optimized: Single full-screen GIF (1 HID write per frame instead of 9)
     std::cout << "\nStarting full-screen GIF animation..." << std::endl;
     
@@ -110,6 +119,14 @@ int main(int argc, char *argv[]) {
       std::cerr << "Failed to start full-screen GIF animation!" << std::endl;
       return 1;
     }
+  } else if (mode == Mode::GRID) {
+    // Decode once, send only the keys whose tile changed each frame
+    std::cout << "\nStarting grid GIF animation..." << std::endl;
+
+    if (!keypad->setGridGifFromFile(gif_path, true)) {
+      std::cerr << "Failed to start grid GIF animation!" << std::endl;
+      return 1;
+    }
   } else {
     // Legacy: Set the same GIF on all 9 buttons (9 HID writes per frame)
     std::cout << "\nLoading GIF and starting animation on all 9 buttons..." << std::endl;
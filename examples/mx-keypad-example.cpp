@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstdio>
@@ -7,6 +8,7 @@
 #include <logilinux/device.h>
 #include <logilinux/events.h>
 #include <logilinux/logilinux.h>
+#include <future>
 #include <random>
 #include <thread>
 #include <vector>
@@ -160,23 +162,39 @@ int main() {
 
   std::cout << "LCD initialized successfully!" << std::endl;
 
-  // Set initial colors for all buttons
+  // Set initial colors for all buttons, painting as many keys per frame as
+  // the LCD link can carry instead of guessing a delay
   std::cout << "\nSetting initial colors..." << std::endl;
   std::random_device rd;
   std::mt19937 gen(rd());
   std::uniform_int_distribution<> dis(0, 255);
 
-  for (int i = 0; i < 9; i++) {
-    uint8_t r = dis(gen);
-    uint8_t g = dis(gen);
-    uint8_t b = dis(gen);
-
-    auto jpeg = generateColorJPEG(r, g, b);
-    if (!jpeg.empty()) {
-      console_device->setKeyImage(i, jpeg);
+  // Rough size of one encoded solid-color key
+  constexpr size_t KEY_JPEG_BYTES = 2048;
+  constexpr size_t KEY_PIXELS = LogiLinux::MXKeypadDevice::KEY_SIZE *
+                                LogiLinux::MXKeypadDevice::KEY_SIZE;
+
+  int next_key = 0;
+  std::promise<void> painted;
+  console_device->onFrame([&](const LogiLinux::FrameBudget &budget) {
+    size_t keys = std::max<size_t>(1, budget.bytes / KEY_JPEG_BYTES);
+    for (; keys > 0 && next_key < 9; keys--, next_key++) {
+      std::vector<uint8_t> pixels(KEY_PIXELS * 3);
+      uint8_t rgb[3] = {static_cast<uint8_t>(dis(gen)),
+                        static_cast<uint8_t>(dis(gen)),
+                        static_cast<uint8_t>(dis(gen))};
+      for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = rgb[i % 3];
+      }
+      console_device->submitKeyPixels(next_key, pixels);
     }
-    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-  }
+    if (next_key == 9) {
+      next_key++;
+      painted.set_value();
+    }
+  });
+  painted.get_future().wait();
+  console_device->onFrame(nullptr);
 
   std::cout << "\nReady! Press buttons to change colors.\n" << std::endl;
 
@@ -0,0 +1,100 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <logilinux/device.h>
+#include <logilinux/logilinux.h>
+#include <logilinux/osc_event_sink.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+std::atomic<bool> running(true);
+
+void signalHandler(int signal) { running = false; }
+
+void printUsage(const char *prog) {
+  std::cerr << "Usage: " << prog << " [--binary] [host:port ...]" << std::endl;
+  std::cerr << "\nForwards dialpad and keypad events as OSC over UDP."
+            << std::endl;
+  std::cerr << "Default endpoint is 127.0.0.1:9000." << std::endl;
+  std::cerr << "\nOptions:" << std::endl;
+  std::cerr << "  --binary   Send compact binary datagrams instead of OSC"
+            << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  auto format = LogiLinux::OscEventSink::Format::OSC;
+  std::vector<std::string> endpoints;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--binary") == 0) {
+      format = LogiLinux::OscEventSink::Format::BINARY;
+    } else if (strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0) {
+      printUsage(argv[0]);
+      return 0;
+    } else {
+      endpoints.push_back(argv[i]);
+    }
+  }
+
+  if (endpoints.empty()) {
+    endpoints.push_back("127.0.0.1:9000");
+  }
+
+  auto sink = std::make_shared<LogiLinux::OscEventSink>(format);
+  for (const auto &endpoint : endpoints) {
+    auto colon = endpoint.rfind(':');
+    if (colon == std::string::npos ||
+        !sink->addEndpoint(endpoint.substr(0, colon),
+                           std::atoi(endpoint.c_str() + colon + 1))) {
+      std::cerr << "Invalid endpoint: " << endpoint << std::endl;
+      return 1;
+    }
+    std::cout << "Sending to " << endpoint << std::endl;
+  }
+
+  signal(SIGINT, signalHandler);
+
+  LogiLinux::Library lib;
+
+  std::vector<LogiLinux::DevicePtr> devices;
+  if (auto dialpad = lib.findDevice(LogiLinux::DeviceType::DIALPAD)) {
+    devices.push_back(dialpad);
+  }
+  if (auto keypad = lib.findDevice(LogiLinux::DeviceType::MX_KEYPAD)) {
+    devices.push_back(keypad);
+  }
+
+  if (devices.empty()) {
+    std::cerr << "No Logitech devices found!" << std::endl;
+    return 1;
+  }
+
+  for (const auto &device : devices) {
+    device->setEventSink(sink);
+    device->startMonitoring();
+    if (device->isMonitoring()) {
+      std::cout << "Forwarding events from " << device->getInfo().name
+                << std::endl;
+    } else {
+      std::cerr << "Failed to monitor " << device->getInfo().name
+                << " (try sudo)" << std::endl;
+    }
+  }
+
+  std::cout << "Press Ctrl+C to exit" << std::endl;
+
+  while (running) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+
+  for (const auto &device : devices) {
+    device->stopMonitoring();
+  }
+
+  return 0;
+}
@@ -0,0 +1,124 @@
+#include "../lib/src/devices/mx_keypad_device.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <logilinux/device.h>
+#include <logilinux/logilinux.h>
+#include <logilinux/scroll_prefetcher.h>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Scrolls a long list of tiles through the keypad grid with the dialpad
+// dial, one row per detent. Tiles are rendered ahead of the scroll.
+
+constexpr int64_t ITEM_COUNT = 1000;
+constexpr int KEY_SIZE = LogiLinux::MXKeypadDevice::KEY_SIZE;
+
+std::atomic<bool> running(true);
+
+void signalHandler(int signal) { running = false; }
+
+// Stand-in for expensive app content: a hue per item with a striped border
+bool renderItem(int64_t item, std::vector<uint8_t> &rgb) {
+  const int hue = static_cast<int>((item * 37) % 360);
+  const int sector = hue / 60;
+  const uint8_t rise = static_cast<uint8_t>((hue % 60) * 255 / 60);
+  const uint8_t fall = 255 - rise;
+  const uint8_t colors[6][3] = {{255, rise, 0}, {fall, 255, 0},
+                                {0, 255, rise}, {0, fall, 255},
+                                {rise, 0, 255}, {255, 0, fall}};
+
+  for (int y = 0; y < KEY_SIZE; y++) {
+    for (int x = 0; x < KEY_SIZE; x++) {
+      const bool border = x < 8 || y < 8 || x >= KEY_SIZE - 8 ||
+                          y >= KEY_SIZE - 8;
+      const bool stripe = border && ((x + y) / 8) % 2 == 0;
+      uint8_t *pixel = &rgb[(y * KEY_SIZE + x) * 3];
+      for (int c = 0; c < 3; c++) {
+        pixel[c] = stripe ? 255 : colors[sector][c];
+      }
+    }
+  }
+  return true;
+}
+
+int main() {
+  LogiLinux::Library lib;
+
+  auto keypad_device = lib.findDevice(LogiLinux::DeviceType::MX_KEYPAD);
+  auto dialpad = lib.findDevice(LogiLinux::DeviceType::DIALPAD);
+  if (!keypad_device || !dialpad) {
+    std::cerr << "Needs both an MX Keypad and a dialpad!" << std::endl;
+    return 1;
+  }
+
+  auto *keypad =
+      dynamic_cast<LogiLinux::MXKeypadDevice *>(keypad_device.get());
+  if (!keypad || !keypad->initialize()) {
+    std::cerr << "Failed to initialize MX Keypad! Try running with sudo."
+              << std::endl;
+    return 1;
+  }
+
+  // Keep the visible grid plus the next few rows ready; a detent scrolls
+  // one row of three items
+  LogiLinux::ScrollPrefetcher::Options options;
+  options.detents_per_item = 1.0 / 3;
+  options.min_ahead = 14;
+  options.max_ahead = 60;
+  options.behind = 3;
+  options.capacity = 80;
+  LogiLinux::ScrollPrefetcher prefetcher(renderItem, options);
+  prefetcher.setBounds(0, ITEM_COUNT - 1);
+
+  std::mutex scroll_mutex;
+  int64_t top = 0; // First item in the grid
+
+  auto show = [&](int64_t first) {
+    for (int key = 0; key < 9; key++) {
+      if (auto jpeg = prefetcher.get(first + key)) {
+        keypad->submitKeyImage(key, *jpeg);
+      }
+    }
+  };
+
+  show(top);
+
+  dialpad->setEventCallback([&](LogiLinux::EventPtr event) {
+    auto rotation = std::dynamic_pointer_cast<LogiLinux::RotationEvent>(event);
+    if (!rotation || rotation->rotation_type != LogiLinux::RotationType::DIAL) {
+      return;
+    }
+    prefetcher.onRotation(*rotation);
+
+    // The dial reports each movement at low and high resolution; scroll on
+    // the low-res detents only
+    if (rotation->raw_event_code == 0x0c) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(scroll_mutex);
+    const int64_t next = std::max<int64_t>(
+        0, std::min<int64_t>(top + rotation->delta * 3, ITEM_COUNT - 9));
+    if (next != top) {
+      top = next;
+      prefetcher.setPosition(top);
+      show(top);
+    }
+  });
+  dialpad->startMonitoring();
+
+  signal(SIGINT, signalHandler);
+  std::cout << "Turn the dial to scroll. Press Ctrl+C to exit" << std::endl;
+
+  while (running) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+
+  dialpad->stopMonitoring();
+  return 0;
+}
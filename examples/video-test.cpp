@@ -3,12 +3,14 @@
  * 
  * This example plays a video file on the MX Keypad's 3x3 LCD grid.
  * Similar to the video.html reference implementation, it decodes video
- * frames, scales them to fit the display, encodes as JPEG, and sends
- * them to the device using setScreenImage().
+ * frames, scales them to fit the display, and submits the raw pixels
+ * with submitScreenPixels(). The device's writer encodes only the newest
+ * frame when the link is free, so frames the link can't carry are dropped
+ * before any JPEG work is done on them.
  * 
  * Requirements:
  *   - ffmpeg libraries (libavcodec, libavformat, libavutil, libswscale)
- *   - libjpeg-turbo
+ *   - libjpeg-turbo (used by the library for encoding)
  * 
  * Usage: ./video-test <video_file.mp4>
  */
@@ -28,8 +30,6 @@ extern "C" {
 #include <libavutil/imgutils.h>
 }
 
-#include <jpeglib.h>
-
 #include <logilinux/events.h>
 #include <logilinux/logilinux.h>
 #include "../lib/src/devices/mx_keypad_device.h"
@@ -39,45 +39,6 @@ std::atomic<bool> paused(false);
 
 void signalHandler(int signal) { running = false; }
 
-// Encode RGB frame to JPEG
-std::vector<uint8_t> encodeJpeg(const uint8_t* rgb_data, int width, int height, int quality = 80) {
-    std::vector<uint8_t> jpeg_buffer;
-    
-    struct jpeg_compress_struct cinfo;
-    struct jpeg_error_mgr jerr;
-    
-    cinfo.err = jpeg_std_error(&jerr);
-    jpeg_create_compress(&cinfo);
-    
-    unsigned char* outbuffer = nullptr;
-    unsigned long outsize = 0;
-    jpeg_mem_dest(&cinfo, &outbuffer, &outsize);
-    
-    cinfo.image_width = width;
-    cinfo.image_height = height;
-    cinfo.input_components = 3;
-    cinfo.in_color_space = JCS_RGB;
-    
-    jpeg_set_defaults(&cinfo);
-    jpeg_set_quality(&cinfo, quality, TRUE);
-    jpeg_start_compress(&cinfo, TRUE);
-    
-    while (cinfo.next_scanline < cinfo.image_height) {
-        const uint8_t* row = rgb_data + cinfo.next_scanline * width * 3;
-        JSAMPROW row_pointer = const_cast<JSAMPROW>(row);
-        jpeg_write_scanlines(&cinfo, &row_pointer, 1);
-    }
-    
-    jpeg_finish_compress(&cinfo);
-    
-    jpeg_buffer.assign(outbuffer, outbuffer + outsize);
-    free(outbuffer);
-    
-    jpeg_destroy_compress(&cinfo);
-    
-    return jpeg_buffer;
-}
-
 int main(int argc, char* argv[]) {
     if (argc < 2) {
         std::cerr << "Usage: " << argv[0] << " <video_file>" << std::endl;
@@ -255,11 +216,8 @@ int main(int argc, char* argv[]) {
                         sws_scale(sws_ctx, frame->data, frame->linesize, 0,
                                   codec_ctx->height, rgb_frame->data, rgb_frame->linesize);
 
-                        // Encode to JPEG
-                        auto jpeg_data = encodeJpeg(rgb_buffer.data(), out_width, out_height, 75);
-
-                        // Send to device
-                        keypad->setScreenImage(jpeg_data);
+                        // Hand raw pixels to the device - encoded only if sent
+                        keypad->submitScreenPixels(rgb_buffer);
 
                         frame_count++;
 
@@ -31,6 +31,22 @@ struct DeviceInfo {
   DeviceType type;
 };
 
+/**
+ * Receives every event straight from a device's event loop, in addition to
+ * the EventCallback. post() is called once per event; flush() is called
+ * when the loop has drained all pending input, so a sink can batch events
+ * that arrive together.
+ */
+class EventSink {
+public:
+  virtual ~EventSink() = default;
+
+  virtual void post(DeviceType source, const Event &event) = 0;
+  virtual void flush() = 0;
+};
+
+using EventSinkPtr = std::shared_ptr<EventSink>;
+
 class Device {
 public:
   virtual ~Device() = default;
@@ -41,6 +57,7 @@ public:
   virtual bool hasCapability(DeviceCapability cap) const = 0;
 
   virtual void setEventCallback(EventCallback callback) = 0;
+  virtual void setEventSink(EventSinkPtr sink) = 0;
   virtual void startMonitoring() = 0;
   virtual void stopMonitoring() = 0;
   virtual bool isMonitoring() const = 0;
@@ -0,0 +1,57 @@
+#ifndef LOGILINUX_OSC_EVENT_SINK_H
+#define LOGILINUX_OSC_EVENT_SINK_H
+
+#include "device.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace LogiLinux {
+
+/**
+ * Event sink that exports device events over UDP, directly from the
+ * device's event loop.
+ *
+ * Events that arrive together are batched into one datagram, which is sent
+ * to every endpoint with a single syscall. All buffers are allocated up
+ * front; posting and flushing do not allocate.
+ *
+ * OSC format: an OSC bundle per datagram, one message per event:
+ *   <prefix>/<dialpad|keypad>/dial     ,ii  delta delta_high_res
+ *   <prefix>/<dialpad|keypad>/wheel    ,ii  delta delta_high_res
+ *   <prefix>/<dialpad|keypad>/button   ,ii  button_code pressed
+ *   <prefix>/<dialpad|keypad>/device   ,i   connected
+ *
+ * Binary format: an 8-byte header ("LLEV", version, record count, 2 bytes
+ * reserved) followed by 20-byte big-endian records: event type (u8),
+ * source device type (u8), code (u16), value (i32), high-res value (i32),
+ * timestamp (u64). Rotation records carry the raw event code and deltas;
+ * button records carry the button code and pressed state as the value.
+ */
+class OscEventSink : public EventSink {
+public:
+  enum class Format { OSC, BINARY };
+
+  explicit OscEventSink(Format format = Format::OSC,
+                        const std::string &address_prefix = "/logilinux");
+  ~OscEventSink() override;
+
+  OscEventSink(const OscEventSink &) = delete;
+  OscEventSink &operator=(const OscEventSink &) = delete;
+
+  /**
+   * Add a UDP destination (numeric IPv4 or IPv6 address)
+   */
+  bool addEndpoint(const std::string &address, uint16_t port);
+
+  void post(DeviceType source, const Event &event) override;
+  void flush() override;
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl;
+};
+
+} // namespace LogiLinux
+
+#endif // LOGILINUX_OSC_EVENT_SINK_H
@@ -0,0 +1,90 @@
+#ifndef LOGILINUX_SCROLL_PREFETCHER_H
+#define LOGILINUX_SCROLL_PREFETCHER_H
+
+#include "events.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace LogiLinux {
+
+/**
+ * Renders and JPEG-encodes list items or pages ahead of a dial-driven
+ * scroll, so newly visible items are ready before they are shown.
+ *
+ * Feed it the dial's rotation events and the item currently in view. It
+ * tracks scroll direction and speed and keeps the next items in that
+ * direction encoded on worker threads - more of them the faster the dial
+ * spins. Reversing direction drops all queued work for the old direction.
+ * At most `capacity` encoded items are kept; the ones farthest from the
+ * current position are evicted first.
+ *
+ * Items are identified by index. The render function fills tightly packed
+ * RGB pixels (width x height) for one item and may be called from several
+ * worker threads at once.
+ */
+class ScrollPrefetcher {
+public:
+  using RenderFunction =
+      std::function<bool(int64_t item, std::vector<uint8_t> &rgb)>;
+  using ImagePtr = std::shared_ptr<const std::vector<uint8_t>>;
+
+  struct Options {
+    int width = 118; // One key by default; use 434x434 for full-screen pages
+    int height = 118;
+    int quality = 85;
+    double detents_per_item = 1.0; // Dial detents that scroll one item
+    std::chrono::milliseconds lookahead{300}; // How far ahead to stay, in time
+    size_t min_ahead = 2;
+    size_t max_ahead = 24;
+    size_t behind = 1;    // Items kept ready in the opposite direction
+    size_t capacity = 48; // Encoded items held at most
+    unsigned workers = 2;
+  };
+
+  explicit ScrollPrefetcher(RenderFunction render);
+  ScrollPrefetcher(RenderFunction render, const Options &options);
+  ~ScrollPrefetcher();
+
+  ScrollPrefetcher(const ScrollPrefetcher &) = delete;
+  ScrollPrefetcher &operator=(const ScrollPrefetcher &) = delete;
+
+  /**
+   * Valid item range (inclusive). Items outside it are never prefetched.
+   */
+  void setBounds(int64_t first, int64_t last);
+
+  /**
+   * Update scroll speed and direction from a dial or wheel event
+   */
+  void onRotation(const RotationEvent &event);
+
+  /**
+   * Item now in view; prefetching runs ahead of it
+   */
+  void setPosition(int64_t item);
+
+  /**
+   * Encoded JPEG for an item. Returns the prefetched image when there is
+   * one, waits if a worker is already encoding it, and otherwise renders
+   * and encodes on the calling thread. Returns nullptr on failure.
+   */
+  ImagePtr get(int64_t item);
+
+  /**
+   * Drop cached images whose content has changed
+   */
+  void invalidate(int64_t item);
+  void invalidateAll();
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pImpl;
+};
+
+} // namespace LogiLinux
+
+#endif // LOGILINUX_SCROLL_PREFETCHER_H
@@ -13,18 +13,19 @@
 
 namespace LogiLinux {
 
-InputMonitor::InputMonitor(const std::string &device_path)
-    : device_path_(device_path), running_(false), should_stop_(false),
-      device_fd_(-1) {}
+InputMonitor::InputMonitor(const std::string &device_path, DeviceType source)
+    : device_path_(device_path), source_(source), running_(false),
+      should_stop_(false), device_fd_(-1) {}
 
 InputMonitor::~InputMonitor() { stop(); }
 
-bool InputMonitor::start(EventCallback callback) {
+bool InputMonitor::start(EventCallback callback, EventSinkPtr sink) {
   if (running_) {
     return false;
   }
 
   callback_ = callback;
+  sink_ = sink;
 
   device_fd_ = open(device_path_.c_str(), O_RDONLY | O_NONBLOCK);
   if (device_fd_ < 0) {
@@ -75,7 +76,10 @@ void InputMonitor::monitorLoop() {
   pfd.fd = device_fd_;
   pfd.events = POLLIN;
 
-  struct input_event ev;
+  // Read everything the kernel has queued in one go; under load this is
+  // what lets the sink batch several events into one flush
+  constexpr size_t MAX_EVENTS = 64;
+  struct input_event events[MAX_EVENTS];
 
   while (!should_stop_) {
     int ret = poll(&pfd, 1, 100);
@@ -89,17 +93,24 @@ void InputMonitor::monitorLoop() {
     }
 
     if (pfd.revents & POLLIN) {
-      ssize_t bytes = read(device_fd_, &ev, sizeof(ev));
+      ssize_t bytes = read(device_fd_, events, sizeof(events));
 
-      if (bytes == sizeof(ev)) {
-        processEvent(ev);
+      if (bytes > 0) {
+        const size_t count = bytes / sizeof(struct input_event);
+        for (size_t i = 0; i < count; i++) {
+          processEvent(events[i]);
+        }
+
+        if (sink_) {
+          sink_->flush();
+        }
       }
     }
   }
 }
 
 void InputMonitor::processEvent(const struct input_event &ev) {
-  if (!callback_) {
+  if (!callback_ && !sink_) {
     return;
   }
 
@@ -139,7 +150,7 @@ void InputMonitor::processEvent(const struct input_event &ev) {
         event->delta = (ev.value > 0) ? 1 : -1;
       }
 
-      callback_(event);
+      dispatch(event);
     }
   }
 
@@ -159,6 +170,15 @@ void InputMonitor::processEvent(const struct input_event &ev) {
       return;
     }
 
+    dispatch(event);
+  }
+}
+
+void InputMonitor::dispatch(const EventPtr &event) {
+  if (sink_) {
+    sink_->post(source_, *event);
+  }
+  if (callback_) {
     callback_(event);
   }
 }
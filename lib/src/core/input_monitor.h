@@ -6,6 +6,7 @@
 #ifndef LOGILINUX_INPUT_MONITOR_H
 #define LOGILINUX_INPUT_MONITOR_H
 
+#include "logilinux/device.h"
 #include "logilinux/events.h"
 #include <atomic>
 #include <functional>
@@ -17,13 +18,15 @@ namespace LogiLinux {
 
 class InputMonitor {
 public:
-  InputMonitor(const std::string &device_path);
+  InputMonitor(const std::string &device_path,
+               DeviceType source = DeviceType::UNKNOWN);
   ~InputMonitor();
 
   /**
-   * Start monitoring events in a background thread
+   * Start monitoring events in a background thread. Either the callback or
+   * the sink may be empty.
    */
-  bool start(EventCallback callback);
+  bool start(EventCallback callback, EventSinkPtr sink = nullptr);
 
   /**
    * Grab the device exclusively (prevents other apps from receiving events)
@@ -51,8 +54,15 @@ private:
    */
   void processEvent(const struct input_event &ev);
 
+  /**
+   * Hand an event to the sink and the callback
+   */
+  void dispatch(const EventPtr &event);
+
   std::string device_path_;
+  DeviceType source_;
   EventCallback callback_;
+  EventSinkPtr sink_;
 
   std::thread monitor_thread_;
   std::atomic<bool> running_;
@@ -0,0 +1,318 @@
+/*
+ * LogiLinux - OSC / UDP Event Sink Implementation
+ */
+
+#include "logilinux/osc_event_sink.h"
+#include <arpa/inet.h>
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace LogiLinux {
+
+// Safe single-frame UDP payload on Ethernet; endpoints are usually local
+// but this keeps datagrams unfragmented if they aren't
+constexpr size_t MAX_DATAGRAM = 1472;
+constexpr size_t MAX_ENDPOINTS = 16;
+
+constexpr size_t BINARY_HEADER_SIZE = 8;
+constexpr size_t BINARY_RECORD_SIZE = 20;
+
+// "#bundle\0" followed by the "immediately" time tag
+static const uint8_t OSC_BUNDLE_HEADER[16] = {'#', 'b', 'u', 'n', 'd', 'l',
+                                              'e', 0,   0,   0,   0,   0,
+                                              0,   0,   0,   1};
+
+static const char *sourceName(DeviceType type) {
+  switch (type) {
+  case DeviceType::DIALPAD:
+    return "dialpad";
+  case DeviceType::MX_KEYPAD:
+    return "keypad";
+  default:
+    return "unknown";
+  }
+}
+
+// OSC strings are NUL-terminated and padded to a multiple of 4 bytes
+static size_t oscStringSize(size_t length) { return (length + 4) & ~size_t(3); }
+
+class OscEventSink::Impl {
+public:
+  Format format;
+  std::string prefix;
+
+  int socket4 = -1;
+  int socket6 = -1;
+  std::vector<sockaddr_in> endpoints4;
+  std::vector<sockaddr_in6> endpoints6;
+  std::array<mmsghdr, MAX_ENDPOINTS> messages4{};
+  std::array<mmsghdr, MAX_ENDPOINTS> messages6{};
+  iovec datagram_iov{};
+
+  std::mutex mutex;
+  std::array<uint8_t, MAX_DATAGRAM> buffer{};
+  size_t length = 0;
+  size_t count = 0;
+
+  Impl(Format f, const std::string &p) : format(f), prefix(p) {
+    endpoints4.reserve(MAX_ENDPOINTS);
+    endpoints6.reserve(MAX_ENDPOINTS);
+    datagram_iov.iov_base = buffer.data();
+  }
+
+  ~Impl() {
+    if (socket4 >= 0) {
+      close(socket4);
+    }
+    if (socket6 >= 0) {
+      close(socket6);
+    }
+  }
+
+  void putInt32(int32_t value) {
+    const uint32_t be = htonl(static_cast<uint32_t>(value));
+    memcpy(buffer.data() + length, &be, 4);
+    length += 4;
+  }
+
+  void putString(const char *str) {
+    const size_t n = strlen(str);
+    memcpy(buffer.data() + length, str, n);
+    length += n;
+  }
+
+  void beginDatagram() {
+    if (format == Format::OSC) {
+      memcpy(buffer.data(), OSC_BUNDLE_HEADER, sizeof(OSC_BUNDLE_HEADER));
+      length = sizeof(OSC_BUNDLE_HEADER);
+    } else {
+      memcpy(buffer.data(), "LLEV", 4);
+      buffer[4] = 1; // Version
+      buffer[5] = 0; // Record count, filled in when sent
+      buffer[6] = 0;
+      buffer[7] = 0;
+      length = BINARY_HEADER_SIZE;
+    }
+  }
+
+  // Append one bundle element; the caller has checked it fits
+  void appendOscMessage(const char *source, const char *kind,
+                        const int32_t *args, size_t nargs) {
+    const size_t address_length =
+        prefix.size() + 1 + strlen(source) + 1 + strlen(kind);
+    const size_t message_size = oscStringSize(address_length) +
+                                oscStringSize(1 + nargs) + 4 * nargs;
+
+    putInt32(static_cast<int32_t>(message_size));
+
+    const size_t address_start = length;
+    memcpy(buffer.data() + length, prefix.data(), prefix.size());
+    length += prefix.size();
+    buffer[length++] = '/';
+    putString(source);
+    buffer[length++] = '/';
+    putString(kind);
+    const size_t address_end = address_start + oscStringSize(address_length);
+    memset(buffer.data() + length, 0, address_end - length);
+    length = address_end;
+
+    const size_t tags_start = length;
+    buffer[length++] = ',';
+    for (size_t i = 0; i < nargs; i++) {
+      buffer[length++] = 'i';
+    }
+    const size_t tags_end = tags_start + oscStringSize(1 + nargs);
+    memset(buffer.data() + length, 0, tags_end - length);
+    length = tags_end;
+
+    for (size_t i = 0; i < nargs; i++) {
+      putInt32(args[i]);
+    }
+  }
+
+  size_t oscElementSize(const char *source, const char *kind, size_t nargs) {
+    const size_t address_length =
+        prefix.size() + 1 + strlen(source) + 1 + strlen(kind);
+    return 4 + oscStringSize(address_length) + oscStringSize(1 + nargs) +
+           4 * nargs;
+  }
+
+  void appendBinaryRecord(DeviceType source, const Event &event,
+                          uint16_t code, int32_t value,
+                          int32_t value_high_res) {
+    uint8_t *record = buffer.data() + length;
+    record[0] = static_cast<uint8_t>(event.type);
+    record[1] = static_cast<uint8_t>(source);
+    record[2] = (code >> 8) & 0xff;
+    record[3] = code & 0xff;
+    length += 4;
+    putInt32(value);
+    putInt32(value_high_res);
+    putInt32(static_cast<int32_t>(event.timestamp >> 32));
+    putInt32(static_cast<int32_t>(event.timestamp & 0xffffffff));
+  }
+
+  // Caller must hold mutex
+  void sendLocked() {
+    if (count == 0) {
+      return;
+    }
+
+    if (format == Format::BINARY) {
+      buffer[5] = static_cast<uint8_t>(count);
+    }
+
+    datagram_iov.iov_len = length;
+    if (!endpoints4.empty()) {
+      sendmmsg(socket4, messages4.data(), endpoints4.size(), MSG_DONTWAIT);
+    }
+    if (!endpoints6.empty()) {
+      sendmmsg(socket6, messages6.data(), endpoints6.size(), MSG_DONTWAIT);
+    }
+
+    length = 0;
+    count = 0;
+  }
+};
+
+OscEventSink::OscEventSink(Format format, const std::string &address_prefix)
+    : pImpl(std::make_unique<Impl>(format, address_prefix)) {}
+
+OscEventSink::~OscEventSink() { flush(); }
+
+bool OscEventSink::addEndpoint(const std::string &address, uint16_t port) {
+  std::lock_guard<std::mutex> lock(pImpl->mutex);
+
+  if (pImpl->endpoints4.size() + pImpl->endpoints6.size() >= MAX_ENDPOINTS) {
+    return false;
+  }
+
+  sockaddr_in addr4{};
+  sockaddr_in6 addr6{};
+
+  if (inet_pton(AF_INET, address.c_str(), &addr4.sin_addr) == 1) {
+    if (pImpl->socket4 < 0) {
+      pImpl->socket4 = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+      if (pImpl->socket4 < 0) {
+        return false;
+      }
+    }
+    addr4.sin_family = AF_INET;
+    addr4.sin_port = htons(port);
+    pImpl->endpoints4.push_back(addr4);
+  } else if (inet_pton(AF_INET6, address.c_str(), &addr6.sin6_addr) == 1) {
+    if (pImpl->socket6 < 0) {
+      pImpl->socket6 = socket(AF_INET6, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+      if (pImpl->socket6 < 0) {
+        return false;
+      }
+    }
+    addr6.sin6_family = AF_INET6;
+    addr6.sin6_port = htons(port);
+    pImpl->endpoints6.push_back(addr6);
+  } else {
+    return false;
+  }
+
+  // Rebuild the message headers - endpoint storage is reserved up front so
+  // these pointers stay valid
+  for (size_t i = 0; i < pImpl->endpoints4.size(); i++) {
+    msghdr &hdr = pImpl->messages4[i].msg_hdr;
+    hdr.msg_name = &pImpl->endpoints4[i];
+    hdr.msg_namelen = sizeof(sockaddr_in);
+    hdr.msg_iov = &pImpl->datagram_iov;
+    hdr.msg_iovlen = 1;
+  }
+  for (size_t i = 0; i < pImpl->endpoints6.size(); i++) {
+    msghdr &hdr = pImpl->messages6[i].msg_hdr;
+    hdr.msg_name = &pImpl->endpoints6[i];
+    hdr.msg_namelen = sizeof(sockaddr_in6);
+    hdr.msg_iov = &pImpl->datagram_iov;
+    hdr.msg_iovlen = 1;
+  }
+
+  return true;
+}
+
+void OscEventSink::post(DeviceType source, const Event &event) {
+  const char *kind = nullptr;
+  int32_t args[2] = {0, 0};
+  size_t nargs = 2;
+  uint16_t code = 0;
+
+  switch (event.type) {
+  case EventType::ROTATION: {
+    const auto &rotation = static_cast<const RotationEvent &>(event);
+    kind = rotation.rotation_type == RotationType::DIAL ? "dial" : "wheel";
+    args[0] = rotation.delta;
+    args[1] = rotation.delta_high_res;
+    code = rotation.raw_event_code;
+    break;
+  }
+  case EventType::BUTTON_PRESS:
+  case EventType::BUTTON_RELEASE: {
+    const auto &button = static_cast<const ButtonEvent &>(event);
+    kind = "button";
+    args[0] = static_cast<int32_t>(button.button_code);
+    args[1] = button.pressed ? 1 : 0;
+    code = static_cast<uint16_t>(button.button_code);
+    break;
+  }
+  case EventType::DEVICE_CONNECTED:
+  case EventType::DEVICE_DISCONNECTED:
+    kind = "device";
+    args[0] = event.type == EventType::DEVICE_CONNECTED ? 1 : 0;
+    nargs = 1;
+    break;
+  }
+
+  if (!kind) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(pImpl->mutex);
+
+  if (pImpl->format == Format::OSC) {
+    const char *name = sourceName(source);
+    const size_t element = pImpl->oscElementSize(name, kind, nargs);
+    if (pImpl->count > 0 && pImpl->length + element > MAX_DATAGRAM) {
+      pImpl->sendLocked();
+    }
+    if (pImpl->count == 0) {
+      pImpl->beginDatagram();
+    }
+    if (pImpl->length + element > MAX_DATAGRAM) {
+      return; // Prefix too long to ever fit
+    }
+    pImpl->appendOscMessage(name, kind, args, nargs);
+  } else {
+    if (pImpl->count > 0 &&
+        pImpl->length + BINARY_RECORD_SIZE > MAX_DATAGRAM) {
+      pImpl->sendLocked();
+    }
+    if (pImpl->count == 0) {
+      pImpl->beginDatagram();
+    }
+    // Buttons carry their code in the code field already
+    if (event.type == EventType::BUTTON_PRESS ||
+        event.type == EventType::BUTTON_RELEASE) {
+      pImpl->appendBinaryRecord(source, event, code, args[1], 0);
+    } else {
+      pImpl->appendBinaryRecord(source, event, code, args[0],
+                                nargs > 1 ? args[1] : 0);
+    }
+  }
+  pImpl->count++;
+}
+
+void OscEventSink::flush() {
+  std::lock_guard<std::mutex> lock(pImpl->mutex);
+  pImpl->sendLocked();
+}
+
+} // namespace LogiLinux
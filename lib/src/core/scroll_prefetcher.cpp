@@ -0,0 +1,366 @@
+/*
+ * LogiLinux - Dial-Driven Scroll Prefetcher Implementation
+ */
+
+#include "logilinux/scroll_prefetcher.h"
+#include "util/jpeg_encoder.h"
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace LogiLinux {
+
+// Hi-res rotation units per dial detent
+constexpr double HIGH_RES_PER_DETENT = 120.0;
+
+// A pause this long ends a flick; speed is measured afresh after it
+constexpr uint64_t SCROLL_IDLE_US = 250000;
+
+static uint64_t steadyNowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// REL_WHEEL_HI_RES, REL_HWHEEL_HI_RES and REL_MISC repeat the movement
+// already reported by their low-res counterparts at finer resolution
+static bool isHighResCode(uint16_t code) {
+  return code == 0x0b || code == 0x0c || code == 0x09;
+}
+
+class ScrollPrefetcher::Impl {
+public:
+  struct Entry {
+    ImagePtr image;       // Null while being rendered
+    bool discard = false; // Invalidated while being rendered
+  };
+
+  RenderFunction render;
+  Options options;
+
+  std::mutex mutex;
+  std::condition_variable work_cv;
+  std::condition_variable done_cv;
+  std::map<int64_t, Entry> cache;
+  std::deque<int64_t> queue; // Nearest first
+  std::vector<std::thread> workers;
+  bool running = true;
+
+  int64_t first = 0;
+  int64_t last = std::numeric_limits<int64_t>::max();
+  int64_t position = 0;
+  int direction = 1;
+  size_t ahead = 0; // Current prefetch window in the scroll direction
+
+  // Scroll speed, measured between rotation reports
+  double detents_per_sec = 0;
+  double pending_detents = 0;
+  uint64_t last_rotation_us = 0;
+  bool high_res_seen = false;
+
+  Impl(RenderFunction r, const Options &o) : render(std::move(r)), options(o) {
+    options.workers = std::max(options.workers, 1u);
+    options.max_ahead = std::max(options.max_ahead, options.min_ahead);
+    for (unsigned i = 0; i < options.workers; i++) {
+      workers.emplace_back(&Impl::workerLoop, this);
+    }
+  }
+
+  ~Impl() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      running = false;
+      queue.clear();
+    }
+    work_cv.notify_all();
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  // Render and encode one item; called without the lock held
+  ImagePtr produce(int64_t item, std::vector<uint8_t> &rgb) {
+    const size_t size = static_cast<size_t>(options.width) * options.height * 3;
+    rgb.resize(size);
+    if (!render(item, rgb) || rgb.size() != size) {
+      return nullptr;
+    }
+    auto jpeg = JpegEncoder::encodeRgb(rgb.data(), options.width,
+                                       options.height, options.quality);
+    if (jpeg.empty()) {
+      return nullptr;
+    }
+    return std::make_shared<const std::vector<uint8_t>>(std::move(jpeg));
+  }
+
+  // Caller must hold mutex
+  void finishLocked(int64_t item, ImagePtr image) {
+    auto it = cache.find(item);
+    if (it != cache.end()) {
+      if (!image || it->second.discard) {
+        cache.erase(it);
+      } else {
+        it->second.image = std::move(image);
+        evictLocked();
+      }
+    }
+    done_cv.notify_all();
+  }
+
+  // Eviction order: items outside the prefetch window first, then the
+  // farthest from the current position
+  uint64_t evictionRank(int64_t item) const {
+    int64_t offset;
+    if (__builtin_sub_overflow(item, position, &offset) ||
+        __builtin_mul_overflow(offset, direction, &offset)) {
+      return std::numeric_limits<uint64_t>::max();
+    }
+    const uint64_t distance = offset < 0 ? 0 - static_cast<uint64_t>(offset)
+                                         : static_cast<uint64_t>(offset);
+    const bool wanted = offset <= static_cast<int64_t>(ahead) &&
+                        offset >= -static_cast<int64_t>(options.behind);
+    return wanted ? distance : (uint64_t(1) << 63) | distance;
+  }
+
+  // Caller must hold mutex
+  void evictLocked() {
+    while (cache.size() > options.capacity) {
+      auto victim = cache.end();
+      uint64_t worst = 0;
+      for (auto it = cache.begin(); it != cache.end(); ++it) {
+        if (!it->second.image) {
+          continue; // Still rendering
+        }
+        const uint64_t rank = evictionRank(it->first);
+        if (victim == cache.end() || rank > worst) {
+          victim = it;
+          worst = rank;
+        }
+      }
+      if (victim == cache.end()) {
+        break;
+      }
+      cache.erase(victim);
+    }
+  }
+
+  bool itemAt(int64_t from, int64_t offset, int64_t &item) const {
+    return !__builtin_add_overflow(from, offset, &item) && item >= first &&
+           item <= last;
+  }
+
+  // Caller must hold mutex
+  void enqueueLocked(int64_t from, int64_t offset) {
+    int64_t item;
+    if (itemAt(from, offset, item) && cache.find(item) == cache.end()) {
+      queue.push_back(item);
+    }
+  }
+
+  // Rebuild the queue around the current position. Whatever was queued
+  // before, possibly for the other direction, is dropped.
+  // Caller must hold mutex
+  void scheduleLocked() {
+    queue.clear();
+
+    // Stay `lookahead` ahead of the scroll, within the cache's capacity
+    const double items_per_sec = detents_per_sec / options.detents_per_item;
+    const double lookahead_sec = options.lookahead.count() / 1000.0;
+    ahead = static_cast<size_t>(std::ceil(items_per_sec * lookahead_sec));
+    ahead = std::min(std::max(ahead, options.min_ahead), options.max_ahead);
+    const size_t room = options.capacity > options.behind + 1
+                            ? options.capacity - options.behind - 1
+                            : 0;
+    ahead = std::min(ahead, room);
+
+    enqueueLocked(position, 0);
+    for (size_t i = 1; i <= ahead; i++) {
+      enqueueLocked(position, direction * static_cast<int64_t>(i));
+    }
+    for (size_t i = 1; i <= options.behind; i++) {
+      enqueueLocked(position, -direction * static_cast<int64_t>(i));
+    }
+  }
+
+  void workerLoop() {
+    std::vector<uint8_t> rgb;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+      if (queue.empty()) {
+        work_cv.wait(lock);
+        continue;
+      }
+
+      const int64_t item = queue.front();
+      queue.pop_front();
+      if (cache.find(item) != cache.end()) {
+        continue; // Ready, or already being rendered
+      }
+      cache[item]; // Claim it so nobody renders it twice
+      lock.unlock();
+
+      ImagePtr image = produce(item, rgb);
+
+      lock.lock();
+      finishLocked(item, std::move(image));
+    }
+  }
+};
+
+ScrollPrefetcher::ScrollPrefetcher(RenderFunction render)
+    : ScrollPrefetcher(std::move(render), Options()) {}
+
+ScrollPrefetcher::ScrollPrefetcher(RenderFunction render,
+                                   const Options &options)
+    : pImpl(std::make_unique<Impl>(std::move(render), options)) {}
+
+ScrollPrefetcher::~ScrollPrefetcher() = default;
+
+void ScrollPrefetcher::setBounds(int64_t first, int64_t last) {
+  {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    pImpl->first = first;
+    pImpl->last = last;
+    for (auto it = pImpl->cache.begin(); it != pImpl->cache.end();) {
+      if (it->second.image && (it->first < first || it->first > last)) {
+        it = pImpl->cache.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    pImpl->scheduleLocked();
+  }
+  pImpl->work_cv.notify_all();
+}
+
+void ScrollPrefetcher::onRotation(const RotationEvent &event) {
+  const bool high_res = isHighResCode(event.raw_event_code);
+  const int32_t delta = high_res ? event.delta_high_res : event.delta;
+  if (delta == 0) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+
+    // Devices that report both resolutions send every movement twice;
+    // once hi-res reports show up, only those are counted
+    if (high_res) {
+      pImpl->high_res_seen = true;
+    } else if (pImpl->high_res_seen) {
+      return;
+    }
+
+    const double detents =
+        high_res ? std::abs(delta) / HIGH_RES_PER_DETENT : std::abs(delta);
+    const uint64_t now = event.timestamp ? event.timestamp : steadyNowUs();
+    const int direction = delta > 0 ? 1 : -1;
+
+    if (direction != pImpl->direction) {
+      // Reversed: the old direction's queued work is dropped below
+      pImpl->direction = direction;
+      pImpl->last_rotation_us = 0;
+    }
+
+    if (pImpl->last_rotation_us == 0 || now < pImpl->last_rotation_us ||
+        now - pImpl->last_rotation_us > SCROLL_IDLE_US) {
+      // Start of a flick - no speed to go on yet
+      pImpl->detents_per_sec = 0;
+      pImpl->pending_detents = 0;
+      pImpl->last_rotation_us = now;
+    } else {
+      // Reports from one input frame share a timestamp; take a sample once
+      // time has moved on
+      pImpl->pending_detents += detents;
+      if (now > pImpl->last_rotation_us) {
+        const double sample = pImpl->pending_detents * 1000000.0 /
+                              (now - pImpl->last_rotation_us);
+        pImpl->detents_per_sec = pImpl->detents_per_sec > 0
+                                     ? (pImpl->detents_per_sec + sample) / 2
+                                     : sample;
+        pImpl->pending_detents = 0;
+        pImpl->last_rotation_us = now;
+      }
+    }
+
+    pImpl->scheduleLocked();
+  }
+  pImpl->work_cv.notify_all();
+}
+
+void ScrollPrefetcher::setPosition(int64_t item) {
+  {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    pImpl->position = item;
+    pImpl->scheduleLocked();
+  }
+  pImpl->work_cv.notify_all();
+}
+
+ScrollPrefetcher::ImagePtr ScrollPrefetcher::get(int64_t item) {
+  std::unique_lock<std::mutex> lock(pImpl->mutex);
+  for (;;) {
+    auto it = pImpl->cache.find(item);
+    if (it == pImpl->cache.end()) {
+      break;
+    }
+    if (it->second.image) {
+      return it->second.image;
+    }
+    // A worker is already on it - finishing beats starting over
+    pImpl->done_cv.wait(lock);
+  }
+
+  // Not prefetched in time: render it here
+  pImpl->cache[item];
+  lock.unlock();
+
+  std::vector<uint8_t> rgb;
+  ImagePtr image = pImpl->produce(item, rgb);
+
+  lock.lock();
+  pImpl->finishLocked(item, image);
+  return image;
+}
+
+void ScrollPrefetcher::invalidate(int64_t item) {
+  {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    auto it = pImpl->cache.find(item);
+    if (it == pImpl->cache.end()) {
+      return;
+    }
+    if (it->second.image) {
+      pImpl->cache.erase(it);
+    } else {
+      it->second.discard = true;
+    }
+    pImpl->scheduleLocked();
+  }
+  pImpl->work_cv.notify_all();
+}
+
+void ScrollPrefetcher::invalidateAll() {
+  {
+    std::lock_guard<std::mutex> lock(pImpl->mutex);
+    for (auto it = pImpl->cache.begin(); it != pImpl->cache.end();) {
+      if (it->second.image) {
+        it = pImpl->cache.erase(it);
+      } else {
+        it->second.discard = true;
+        ++it;
+      }
+    }
+    pImpl->scheduleLocked();
+  }
+  pImpl->work_cv.notify_all();
+}
+
+} // namespace LogiLinux
@@ -0,0 +1,217 @@
+/*
+ * LogiLinux - USB Bus Scheduler Implementation
+ */
+
+#include "usb_bus_scheduler.h"
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <map>
+
+namespace LogiLinux {
+
+UsbBusScheduler::UsbBusScheduler(const std::string &bus_id)
+    : bus_id_(bus_id), owner_(-1),
+      owner_priority_(WritePriority::INTERACTIVE), next_id_(0),
+      cursor_{0, 0}, credits_{0, 0} {}
+
+std::shared_ptr<UsbBusScheduler>
+UsbBusScheduler::forHidraw(const std::string &hidraw_path) {
+  static std::mutex registry_mutex;
+  static std::map<std::string, std::weak_ptr<UsbBusScheduler>> registry;
+
+  std::string bus_id = busIdForHidraw(hidraw_path);
+  if (bus_id.empty()) {
+    bus_id = hidraw_path;
+  }
+
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  auto scheduler = registry[bus_id].lock();
+  if (!scheduler) {
+    scheduler = std::make_shared<UsbBusScheduler>(bus_id);
+    registry[bus_id] = scheduler;
+  }
+  return scheduler;
+}
+
+std::string UsbBusScheduler::busIdForHidraw(const std::string &hidraw_path) {
+  std::string name = hidraw_path.substr(hidraw_path.find_last_of('/') + 1);
+  std::string sysfs = "/sys/class/hidraw/" + name + "/device";
+
+  // Resolves to something like
+  // /sys/devices/pci0000:00/0000:00:14.0/usb1/1-2/1-2.4/1-2.4:1.2/0003:...
+  char resolved[PATH_MAX];
+  if (!realpath(sysfs.c_str(), resolved)) {
+    return "";
+  }
+
+  std::string path = resolved;
+  size_t start = 0;
+  while (start < path.size()) {
+    size_t end = path.find('/', start);
+    if (end == std::string::npos) {
+      end = path.size();
+    }
+
+    std::string component = path.substr(start, end - start);
+    if (component.size() > 3 && component.compare(0, 3, "usb") == 0 &&
+        std::all_of(component.begin() + 3, component.end(), ::isdigit)) {
+      return component;
+    }
+
+    start = end + 1;
+  }
+
+  return "";
+}
+
+int UsbBusScheduler::addClient(unsigned weight) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  int id = next_id_++;
+  clients_.push_back({id, std::max(weight, 1u), false,
+                      WritePriority::INTERACTIVE});
+  return id;
+}
+
+void UsbBusScheduler::removeClient(int client) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  clients_.erase(std::remove_if(clients_.begin(), clients_.end(),
+                                [client](const Client &c) {
+                                  return c.id == client;
+                                }),
+                 clients_.end());
+
+  for (int i = 0; i < 2; i++) {
+    cursor_[i] = clients_.empty() ? 0 : cursor_[i] % clients_.size();
+    credits_[i] = 0;
+  }
+
+  if (owner_ == client) {
+    owner_ = -1;
+    grantLocked();
+    cv_.notify_all();
+  }
+}
+
+void UsbBusScheduler::setWeight(int client, unsigned weight) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (Client *c = findLocked(client)) {
+    c->weight = std::max(weight, 1u);
+  }
+}
+
+void UsbBusScheduler::acquire(int client, WritePriority priority) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  Client *c = findLocked(client);
+  if (!c) {
+    return;
+  }
+
+  if (owner_ == client) {
+    owner_priority_ = priority;
+    return; // Still holding the bus from the previous packet
+  }
+
+  c->waiting = true;
+  c->priority = priority;
+
+  if (owner_ < 0) {
+    grantLocked();
+    if (owner_ == client) {
+      return; // Uncontended fast path
+    }
+    cv_.notify_all();
+  }
+
+  cv_.wait(lock, [this, client]() { return owner_ == client; });
+}
+
+void UsbBusScheduler::release(int client, bool more_pending) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (owner_ != client) {
+    return;
+  }
+
+  // Spend the rest of this round's credit without giving the bus up
+  // between packets - a waiter would otherwise always win the handoff
+  const int cls = static_cast<int>(owner_priority_);
+  if (more_pending && credits_[cls] > 0 &&
+      !(owner_priority_ == WritePriority::BULK &&
+        interactiveWaitingLocked())) {
+    credits_[cls]--;
+    return;
+  }
+
+  owner_ = -1;
+  grantLocked();
+  if (owner_ >= 0) {
+    cv_.notify_all();
+  }
+}
+
+void UsbBusScheduler::grantLocked() {
+  int index = pickLocked(WritePriority::INTERACTIVE);
+  if (index < 0) {
+    index = pickLocked(WritePriority::BULK);
+  }
+  if (index < 0) {
+    return;
+  }
+
+  clients_[index].waiting = false;
+  owner_ = clients_[index].id;
+  owner_priority_ = clients_[index].priority;
+}
+
+bool UsbBusScheduler::interactiveWaitingLocked() const {
+  for (const auto &c : clients_) {
+    if (c.waiting && c.priority == WritePriority::INTERACTIVE) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int UsbBusScheduler::pickLocked(WritePriority priority) {
+  const size_t count = clients_.size();
+  if (count == 0) {
+    return -1;
+  }
+
+  const int cls = static_cast<int>(priority);
+  auto eligible = [this, priority](size_t i) {
+    return clients_[i].waiting && clients_[i].priority == priority;
+  };
+
+  // Keep serving the current client while it has credit left this round
+  size_t current = cursor_[cls] % count;
+  if (credits_[cls] > 0 && eligible(current)) {
+    credits_[cls]--;
+    return static_cast<int>(current);
+  }
+
+  // Otherwise move on to the next waiting client, which gets a fresh
+  // round of credit proportional to its weight
+  for (size_t step = 1; step <= count; step++) {
+    size_t i = (current + step) % count;
+    if (eligible(i)) {
+      cursor_[cls] = i;
+      credits_[cls] = clients_[i].weight - 1;
+      return static_cast<int>(i);
+    }
+  }
+
+  return -1;
+}
+
+UsbBusScheduler::Client *UsbBusScheduler::findLocked(int client) {
+  for (auto &c : clients_) {
+    if (c.id == client) {
+      return &c;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace LogiLinux
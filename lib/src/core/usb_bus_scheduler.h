@@ -0,0 +1,96 @@
+/*
+ * LogiLinux - USB Bus Scheduler
+ * Shares LCD upload bandwidth fairly between devices on the same USB bus
+ */
+
+#ifndef LOGILINUX_USB_BUS_SCHEDULER_H
+#define LOGILINUX_USB_BUS_SCHEDULER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace LogiLinux {
+
+enum class WritePriority {
+  INTERACTIVE = 0, // Direct key updates, served first
+  BULK = 1,        // Animations, streamed frames, refinements
+};
+
+class UsbBusScheduler {
+public:
+  explicit UsbBusScheduler(const std::string &bus_id);
+
+  /**
+   * Get the scheduler shared by every device on the same USB bus as the
+   * given hidraw node. Devices whose topology can't be resolved get a
+   * scheduler of their own.
+   */
+  static std::shared_ptr<UsbBusScheduler>
+  forHidraw(const std::string &hidraw_path);
+
+  /**
+   * Resolve the USB bus (e.g. "usb1") a hidraw node is attached to via
+   * sysfs. Returns an empty string if it can't be determined.
+   */
+  static std::string busIdForHidraw(const std::string &hidraw_path);
+
+  const std::string &busId() const { return bus_id_; }
+
+  /**
+   * Register a device; weight is its share of packets per round
+   */
+  int addClient(unsigned weight = 1);
+  void removeClient(int client);
+  void setWeight(int client, unsigned weight);
+
+  /**
+   * Block until the client may send one packet. Waiting interactive
+   * packets are granted before bulk ones; within a class clients are
+   * served weighted round-robin.
+   */
+  void acquire(int client, WritePriority priority);
+
+  /**
+   * Hand the bus to the next waiting client. If the client has more
+   * packets to send and credit left this round it keeps the bus, unless
+   * it is sending bulk and an interactive packet is waiting.
+   */
+  void release(int client, bool more_pending = false);
+
+private:
+  struct Client {
+    int id;
+    unsigned weight;
+    bool waiting;
+    WritePriority priority;
+  };
+
+  /**
+   * Choose the next client to send (caller must hold mutex_)
+   */
+  void grantLocked();
+  int pickLocked(WritePriority priority);
+  Client *findLocked(int client);
+  bool interactiveWaitingLocked() const;
+
+  std::string bus_id_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::vector<Client> clients_;
+  int owner_;   // Client currently sending, -1 when the bus is free
+  WritePriority owner_priority_;
+  int next_id_;
+
+  // Round-robin position and remaining credit, per priority class
+  size_t cursor_[2];
+  unsigned credits_[2];
+};
+
+} // namespace LogiLinux
+
+#endif // LOGILINUX_USB_BUS_SCHEDULER_H
@@ -5,7 +5,8 @@
 namespace LogiLinux {
 
 DialpadDevice::DialpadDevice(const DeviceInfo &info)
-    : info_(info), monitor_(std::make_unique<InputMonitor>(info.device_path)) {
+    : info_(info),
+      monitor_(std::make_unique<InputMonitor>(info.device_path, info.type)) {
 
   capabilities_.push_back(DeviceCapability::ROTATION);
   capabilities_.push_back(DeviceCapability::BUTTONS);
@@ -23,9 +24,11 @@ void DialpadDevice::setEventCallback(EventCallback callback) {
   event_callback_ = callback;
 }
 
+void DialpadDevice::setEventSink(EventSinkPtr sink) { event_sink_ = sink; }
+
 void DialpadDevice::startMonitoring() {
-  if (event_callback_) {
-    monitor_->start(event_callback_);
+  if (event_callback_ || event_sink_) {
+    monitor_->start(event_callback_, event_sink_);
   }
 }
 
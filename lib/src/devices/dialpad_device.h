@@ -18,6 +18,7 @@ public:
   bool hasCapability(DeviceCapability cap) const override;
 
   void setEventCallback(EventCallback callback) override;
+  void setEventSink(EventSinkPtr sink) override;
   void startMonitoring() override;
   void stopMonitoring() override;
   bool isMonitoring() const override;
@@ -28,6 +29,7 @@ private:
   DeviceInfo info_;
   std::vector<DeviceCapability> capabilities_;
   EventCallback event_callback_;
+  EventSinkPtr event_sink_;
   std::unique_ptr<InputMonitor> monitor_;
 };
 
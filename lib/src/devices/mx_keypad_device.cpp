@@ -1,17 +1,27 @@
 #include "mx_keypad_device.h"
+#include "../core/usb_bus_scheduler.h"
 #include "../util/gif_decoder.h"
+#include "../util/jpeg_encoder.h"
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cerrno>
+#include <condition_variable>
 #include <cstring>
+#include <deque>
 #include <fcntl.h>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <linux/hidraw.h>
 #include <map>
+#include <mutex>
 #include <poll.h>
+#include <pthread.h>
+#include <sched.h>
 #include <set>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
-#include <sys/uio.h>
 #include <thread>
 #include <unistd.h>
 
@@ -20,6 +30,22 @@ namespace LogiLinux {
 constexpr size_t MAX_PACKET_SIZE = 4095;
 constexpr size_t LCD_SIZE = 118;
 
+// Largest JPEG that fits in the first packet after its 20-byte header
+constexpr size_t SINGLE_PACKET_PAYLOAD = MAX_PACKET_SIZE - 20;
+constexpr int FULL_JPEG_QUALITY = 85;
+
+// The first packet header carries the JPEG length in 16 bits; screen and
+// region encodes lower their quality until they fit
+constexpr size_t MAX_JPEG_SIZE = 0xFFFF;
+
+// How long the link must be quiet before a refinement is sent
+constexpr auto REFINE_IDLE_DELAY = std::chrono::milliseconds(50);
+
+// Frame pacing bounds and the link estimate used until uploads are measured
+constexpr auto MIN_FRAME_INTERVAL = std::chrono::microseconds(1000000 / 60);
+constexpr auto MAX_FRAME_INTERVAL = std::chrono::microseconds(1000000);
+constexpr uint64_t DEFAULT_LINK_BYTES_PER_SEC = 1000000;
+
 // Uber-optimization: Pre-computed packet headers for zero-copy assembly
 alignas(64) static const uint8_t PACKET_BASE_HEADER[4] = {0x14, 0xff, 0x02, 0x2b};
 alignas(64) static const uint8_t PACKET1_GEOMETRY[6] = {0x01, 0x00, 0x01, 0x00, 0x00, 0x00};
@@ -44,7 +70,9 @@ public:
   }
 };
 
-static PacketBufferPool packet_pool;
+// Per thread: packets are built by the writer, the refiner, animations and
+// direct uploads concurrently, and must never share a scratch buffer
+static thread_local PacketBufferPool packet_pool;
 
 struct KeyAnimation {
   GifAnimation animation;
@@ -55,6 +83,75 @@ struct KeyAnimation {
   KeyAnimation() : running(false), current_frame(0) {}
 };
 
+// One GIF spread across the 3x3 key grid. Each frame keeps JPEGs only for
+// the tiles that changed since the frame before it.
+struct GridFrame {
+  std::array<std::vector<uint8_t>, 9> tiles; // Empty = unchanged
+  int delay_ms;
+};
+
+struct GridAnimation {
+  std::vector<GridFrame> frames;
+  std::array<std::vector<uint8_t>, 9> first_tiles; // Complete first frame
+  bool loop;
+  std::atomic<bool> running;
+  std::thread animation_thread;
+
+  GridAnimation() : loop(true), running(false) {}
+};
+
+// One staged image: raw pixels (encoded only when the writer is about to
+// send them) or a ready-made JPEG
+struct StagedImage {
+  std::vector<uint8_t> data;
+  bool encoded = false; // data is JPEG rather than RGB
+  uint64_t seq = 0;     // Submission order, keeps overlapping paints ordered
+};
+
+// Double-buffered staging for one upload target (a key or the full screen).
+// Producers publish into the back buffer with an atomic pointer swap and
+// the writer swaps it out into its own front buffer, so a newer submission
+// simply replaces an older one that hasn't gone out yet. Buffers are
+// recycled through the spare pointer to avoid steady-state allocations.
+struct LcdSlot {
+  std::atomic<StagedImage *> back{nullptr};  // Published, not yet taken
+  std::atomic<StagedImage *> spare{nullptr}; // Free buffer for producers
+  std::atomic<uint64_t> generation{0}; // Seq of the newest content on it
+  std::atomic<uint64_t> superseded{0}; // Seq of the newest content covering it
+  std::unique_ptr<StagedImage> refine; // Preview sent, full quality owed
+
+  ~LcdSlot() {
+    delete back.load();
+    delete spare.load();
+  }
+};
+
+// A direct upload (setKeyImage, setRawImage, animations) or refinement
+// waiting for the writer. It goes out in seq order with the staged images,
+// so it can't be painted over by older pixels still waiting to be sent.
+struct DirectUpload {
+  uint64_t seq = 0;
+  std::vector<std::vector<uint8_t>> packets;
+  WritePriority priority = WritePriority::INTERACTIVE;
+  int refine_key = -1;     // Refinements are dropped once their key changes
+  uint64_t refine_seq = 0; // Seq of the preview being refined
+
+  // Region pixels (submitRawPixels), encoded when the writer gets to them
+  std::vector<uint8_t> rgb;
+  uint16_t x = 0, y = 0, width = 0, height = 0;
+  bool done = false;
+  bool ok = false;
+};
+
+constexpr int SCREEN_SLOT = 9;
+constexpr int SLOT_COUNT = 10; // Keys 0-8 plus the full screen
+
+static int64_t steadyNowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
 struct MXKeypadDevice::Impl {
   int hidraw_fd = -1;
   std::string hidraw_path;
@@ -70,6 +167,47 @@ struct MXKeypadDevice::Impl {
   // Full-screen GIF animation
   std::unique_ptr<KeyAnimation> screen_animation;
 
+  // GIF sliced across the key grid
+  std::unique_ptr<GridAnimation> grid_animation;
+
+  std::atomic<int64_t> last_write_ns{0};
+
+  // Bandwidth shared with other devices on the same USB bus
+  std::shared_ptr<UsbBusScheduler> bus;
+  int bus_client = -1;
+  unsigned bus_weight = 1;
+
+  // Measured link throughput (moving average) and total bytes sent
+  std::atomic<uint64_t> link_bytes_per_sec{DEFAULT_LINK_BYTES_PER_SEC};
+  std::atomic<uint64_t> bytes_sent{0};
+
+  // Lazily encoded uploads and progressive refinement. The writer sends
+  // staged images; the refiner upgrades previews when idle. Producers only
+  // touch the slots' atomics and the wakeup eventfd, never a lock.
+  std::atomic<UploadMode> upload_mode{UploadMode::FULL_QUALITY};
+  std::array<LcdSlot, SLOT_COUNT> slots;
+  std::atomic<uint64_t> next_seq{1};
+  int wake_fd = -1;
+  std::atomic<bool> wake_posted{false};
+  std::mutex slot_mutex; // Direct uploads, refinement handoff, draining
+  std::deque<std::shared_ptr<DirectUpload>> uploads;
+  std::condition_variable upload_cv;
+  std::condition_variable refine_cv;
+  std::condition_variable drained_cv; // Writer has nothing left to send
+  std::thread writer_thread;
+  std::thread refine_thread;
+  std::atomic<bool> writers_running{false};
+  std::atomic<bool> writer_busy{false};
+
+  // Frame tick (see onFrame). The callback is held by shared_ptr so the
+  // frame thread can call it without holding frame_mutex.
+  std::shared_ptr<FrameCallback> frame_callback;
+  bool in_callback = false; // Frame thread is running a callback
+  std::mutex frame_mutex;
+  std::condition_variable frame_cv;
+  std::thread frame_thread;
+  std::atomic<bool> frame_running{false};
+
   const std::vector<std::vector<uint8_t>> INIT_REPORTS = {
       {0x11, 0xff, 0x0b, 0x3b, 0x01, 0xa1, 0x03, 0x00, 0x00, 0x00,
        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
@@ -79,6 +217,10 @@ struct MXKeypadDevice::Impl {
 
   std::vector<std::vector<uint8_t>>
   generateImagePackets(int keyIndex, const std::vector<uint8_t> &jpegData) {
+    if (jpegData.size() > MAX_JPEG_SIZE) {
+      return {}; // Its length wouldn't fit the header
+    }
+
     // Uber-optimized: Pre-calculate everything for zero-copy assembly
     const size_t PACKET1_HEADER = 20;
     const size_t SUBSEQUENT_HEADER = 5;
@@ -178,6 +320,10 @@ struct MXKeypadDevice::Impl {
   std::vector<std::vector<uint8_t>>
   generateRawImagePackets(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
                           const std::vector<uint8_t> &jpegData) {
+    if (jpegData.size() > MAX_JPEG_SIZE) {
+      return {}; // Its length wouldn't fit the header
+    }
+
     const size_t PACKET1_HEADER = 20;
     const size_t SUBSEQUENT_HEADER = 5;
 
@@ -253,6 +399,733 @@ struct MXKeypadDevice::Impl {
     return result;
   }
 
+  // Only the writer thread sends, so multi-packet uploads never interleave
+  // on the wire
+  bool writePackets(const std::vector<std::vector<uint8_t>> &packets,
+                    WritePriority priority) {
+    if (packets.empty()) {
+      return false;
+    }
+
+    const int64_t start_ns = steadyNowNs();
+    size_t totalWritten = 0;
+    bool ok = true;
+
+    // One packet per bus grant, so other keypads on the same bus can
+    // interleave their packets with a long upload of ours
+    for (size_t i = 0; i < packets.size(); i++) {
+      const auto &packet = packets[i];
+      bus->acquire(bus_client, priority);
+      const ssize_t written = write(hidraw_fd, packet.data(), packet.size());
+      ok = written == static_cast<ssize_t>(packet.size());
+      bus->release(bus_client, ok && i + 1 < packets.size());
+
+      if (!ok) {
+        break;
+      }
+      totalWritten += written;
+    }
+
+    const int64_t end_ns = steadyNowNs();
+    last_write_ns = end_ns;
+
+    // hidraw writes complete when the report is on the wire, so the time
+    // spent here (including waits for our share of the bus) is a direct
+    // sample of the throughput this device actually gets
+    if (totalWritten > 0) {
+      bytes_sent += totalWritten;
+      if (end_ns > start_ns) {
+        const uint64_t sample = static_cast<uint64_t>(totalWritten) *
+                                1000000000ull / (end_ns - start_ns);
+        link_bytes_per_sec = (link_bytes_per_sec * 3 + sample) / 4;
+      }
+    }
+
+    return ok;
+  }
+
+  // Hand a direct upload to the writer and wait until it is on the wire.
+  // claim is called with the upload's seq, under slot_mutex, to mark the
+  // targets it replaces.
+  bool queueUpload(std::vector<std::vector<uint8_t>> packets,
+                   WritePriority priority,
+                   const std::function<void(uint64_t)> &claim) {
+    auto upload = std::make_shared<DirectUpload>();
+    upload->packets = std::move(packets);
+    upload->priority = priority;
+
+    std::unique_lock<std::mutex> lock(slot_mutex);
+    if (!writers_running) {
+      return false;
+    }
+    upload->seq = next_seq++;
+    claim(upload->seq);
+    uploads.push_back(upload);
+    wakeWriter();
+    upload_cv.wait(lock, [&]() { return upload->done; });
+    return upload->ok;
+  }
+
+  // Direct JPEG uploads, superseding anything pending for the same target
+  bool uploadKeyImage(int keyIndex, const std::vector<uint8_t> &jpegData,
+                      WritePriority priority) {
+    return queueUpload(generateImagePackets(keyIndex, jpegData), priority,
+                       [&](uint64_t seq) { cover(keyIndex, seq); });
+  }
+
+  bool uploadRawImage(uint16_t x, uint16_t y, uint16_t width,
+                      uint16_t height, const std::vector<uint8_t> &jpegData,
+                      WritePriority priority) {
+    return queueUpload(
+        generateRawImagePackets(x, y, width, height, jpegData), priority,
+        [&](uint64_t seq) { supersedeRegion(x, y, width, height, seq); });
+  }
+
+  static void raiseTo(std::atomic<uint64_t> &value, uint64_t seq) {
+    uint64_t current = value;
+    while (current < seq && !value.compare_exchange_weak(current, seq)) {
+    }
+  }
+
+  // Content with this seq is about to cover the whole target, so anything
+  // staged for it before seq never needs to be sent
+  void cover(int slotIndex, uint64_t seq) {
+    raiseTo(slots[slotIndex].generation, seq);
+    raiseTo(slots[slotIndex].superseded, seq);
+  }
+
+  // Supersede every target the given screen region fully covers. Targets
+  // it only partly overlaps keep their staged pixels but lose refinement.
+  void supersedeRegion(uint16_t x, uint16_t y, uint16_t width,
+                       uint16_t height, uint64_t seq) {
+    const auto mark = [&](int slotIndex, int sx, int sy, int size_x,
+                          int size_y) {
+      if (x <= sx && y <= sy && x + width >= sx + size_x &&
+          y + height >= sy + size_y) {
+        cover(slotIndex, seq);
+      } else if (x < sx + size_x && sx < x + width && y < sy + size_y &&
+                 sy < y + height) {
+        raiseTo(slots[slotIndex].generation, seq);
+      }
+    };
+    for (int keyIndex = 0; keyIndex < 9; keyIndex++) {
+      mark(keyIndex, 23 + (keyIndex % 3) * (118 + 40),
+           6 + (keyIndex / 3) * (118 + 40), LCD_SIZE, LCD_SIZE);
+    }
+    mark(SCREEN_SLOT, 23, 6, MXKeypadDevice::SCREEN_WIDTH,
+         MXKeypadDevice::SCREEN_HEIGHT);
+  }
+
+  // Nothing newer has been submitted or uploaded for the target
+  bool isCurrent(int slotIndex, uint64_t seq) {
+    return slots[slotIndex].generation == seq;
+  }
+
+  // Newer content covers the target; sending this would be wasted
+  bool isSuperseded(int slotIndex, uint64_t seq) {
+    return seq < slots[slotIndex].superseded;
+  }
+
+  // Hand a buffer back to a slot's producers, freeing whatever it displaces
+  void recycle(int slotIndex, StagedImage *image) {
+    delete slots[slotIndex].spare.exchange(image);
+  }
+
+  // A recycled buffer for the slot if there is one, else a new one
+  std::unique_ptr<StagedImage> takeBuffer(int slotIndex) {
+    std::unique_ptr<StagedImage> image(slots[slotIndex].spare.exchange(nullptr));
+    if (!image) {
+      image = std::make_unique<StagedImage>();
+    }
+    return image;
+  }
+
+  // Fill a buffer and make it the target's newest content. Earlier staged
+  // images are still sent if the writer already has them; only images
+  // nobody has taken yet are replaced.
+  std::unique_ptr<StagedImage> stage(int slotIndex,
+                                     const std::vector<uint8_t> &data,
+                                     bool encoded) {
+    std::unique_ptr<StagedImage> image = takeBuffer(slotIndex);
+    image->data.assign(data.begin(), data.end());
+    image->encoded = encoded;
+    image->seq = next_seq++;
+
+    if (slotIndex == SCREEN_SLOT) {
+      // Older key pixels would be painted over anyway
+      for (int i = 0; i < 9; i++) {
+        cover(i, image->seq);
+      }
+    }
+    raiseTo(slots[slotIndex].generation, image->seq);
+    return image;
+  }
+
+  // Queue an image for the writer, replacing anything not yet sent. Lock
+  // free, so any number of threads can submit without blocking.
+  void submit(int slotIndex, const std::vector<uint8_t> &data, bool encoded) {
+    LcdSlot &slot = slots[slotIndex];
+    StagedImage *held = stage(slotIndex, data, encoded).release();
+
+    // Racing producers can swap an older image over a newer one; whoever
+    // gets the newer one back out puts it back in
+    for (;;) {
+      const uint64_t held_seq = held->seq;
+      StagedImage *displaced = slot.back.exchange(held);
+      if (!displaced) {
+        break;
+      }
+      if (displaced->seq < held_seq) {
+        recycle(slotIndex, displaced);
+        break;
+      }
+      held = displaced;
+    }
+
+    wakeWriter();
+  }
+
+  // Only the first wakeup since the writer last looked needs a syscall
+  void wakeWriter() {
+    if (!wake_posted.exchange(true)) {
+      eventfd_write(wake_fd, 1);
+    }
+  }
+
+  bool hasStaged() const {
+    for (const auto &slot : slots) {
+      if (slot.back != nullptr) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Encode a staged image into upload packets. progressive is set when
+  // they carry a single-packet preview that still needs refining.
+  std::vector<std::vector<uint8_t>> encodeStaged(int slotIndex,
+                                                 const StagedImage &image,
+                                                 bool &progressive) {
+    const bool screen = slotIndex == SCREEN_SLOT;
+    progressive = !screen && !image.encoded &&
+                  upload_mode == UploadMode::PROGRESSIVE;
+    const uint8_t *rgb = image.data.data();
+
+    std::vector<uint8_t> encoded;
+    if (!image.encoded) {
+      // Smallest possible transfer first: a single packet at whatever
+      // quality fits, so perceived latency is one packet
+      encoded = screen ? JpegEncoder::encodeRgbToFit(
+                             rgb, MXKeypadDevice::SCREEN_WIDTH,
+                             MXKeypadDevice::SCREEN_HEIGHT, MAX_JPEG_SIZE,
+                             FULL_JPEG_QUALITY)
+                : progressive
+                    ? JpegEncoder::encodeRgbToFit(rgb, LCD_SIZE, LCD_SIZE,
+                                                  SINGLE_PACKET_PAYLOAD)
+                    : JpegEncoder::encodeRgb(rgb, LCD_SIZE, LCD_SIZE,
+                                             FULL_JPEG_QUALITY);
+      if (encoded.empty() && progressive) {
+        // Not even the lowest quality fits in one packet - send the full
+        // quality image in one go, with nothing left to refine
+        progressive = false;
+        encoded = JpegEncoder::encodeRgb(rgb, LCD_SIZE, LCD_SIZE,
+                                         FULL_JPEG_QUALITY);
+      }
+      if (encoded.empty()) {
+        return {};
+      }
+    }
+    const std::vector<uint8_t> &jpeg = image.encoded ? image.data : encoded;
+
+    return screen
+               ? generateRawImagePackets(23, 6, MXKeypadDevice::SCREEN_WIDTH,
+                                         MXKeypadDevice::SCREEN_HEIGHT, jpeg)
+               : generateImagePackets(slotIndex, jpeg);
+  }
+
+  // Queue the full-quality version of a preview that is on the wire, but
+  // only if nothing newer landed on its key meanwhile
+  void queueRefinement(int slotIndex, std::unique_ptr<StagedImage> &image) {
+    {
+      std::lock_guard<std::mutex> lock(slot_mutex);
+      if (!isCurrent(slotIndex, image->seq)) {
+        return;
+      }
+      std::swap(slots[slotIndex].refine, image);
+    }
+    refine_cv.notify_one();
+  }
+
+  // Encode and send a staged image, unless content covering its target has
+  // been uploaded since. A newer staged image doesn't stop it: that one
+  // simply follows, so a fast producer can't starve the display. In
+  // progressive mode key pixels get a single-packet preview and are handed
+  // to the refiner; otherwise the image is left with the caller.
+  bool sendPixels(int slotIndex, std::unique_ptr<StagedImage> &image) {
+    bool progressive;
+    auto packets = encodeStaged(slotIndex, *image, progressive);
+    if (packets.empty()) {
+      return false;
+    }
+
+    if (isSuperseded(slotIndex, image->seq)) {
+      return true;
+    }
+    // Key updates are what users are waiting on; streamed full-screen
+    // frames yield to other devices' key updates
+    if (!writePackets(packets, slotIndex == SCREEN_SLOT
+                                   ? WritePriority::BULK
+                                   : WritePriority::INTERACTIVE)) {
+      return false;
+    }
+
+    if (progressive) {
+      queueRefinement(slotIndex, image);
+    }
+    return true;
+  }
+
+  // Send the oldest queued direct upload if nothing staged is older
+  bool sendUpload(uint64_t before_seq) {
+    std::shared_ptr<DirectUpload> upload;
+    {
+      std::lock_guard<std::mutex> lock(slot_mutex);
+      if (uploads.empty() || uploads.front()->seq > before_seq) {
+        return false;
+      }
+      upload = uploads.front();
+      uploads.pop_front();
+    }
+
+    if (!upload->rgb.empty()) {
+      auto jpeg = JpegEncoder::encodeRgbToFit(upload->rgb.data(),
+                                              upload->width, upload->height,
+                                              MAX_JPEG_SIZE, FULL_JPEG_QUALITY);
+      if (!jpeg.empty()) {
+        upload->packets = generateRawImagePackets(
+            upload->x, upload->y, upload->width, upload->height, jpeg);
+      }
+    }
+
+    bool ok = true;
+    if (upload->refine_key < 0 ||
+        isCurrent(upload->refine_key, upload->refine_seq)) {
+      ok = writePackets(upload->packets, upload->priority);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(slot_mutex);
+      upload->done = true;
+      upload->ok = ok;
+    }
+    upload_cv.notify_all();
+    return true;
+  }
+
+  // Queue region pixels for the writer without waiting. Each region has at
+  // most one pending entry: newer pixels replace the ones waiting for it,
+  // which are never encoded.
+  bool submitRegion(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                    const std::vector<uint8_t> &rgbData) {
+    {
+      std::lock_guard<std::mutex> lock(slot_mutex);
+      if (!writers_running) {
+        return false;
+      }
+
+      std::shared_ptr<DirectUpload> upload;
+      for (auto it = uploads.begin(); it != uploads.end(); ++it) {
+        const DirectUpload &pending = **it;
+        if (!pending.rgb.empty() && pending.x == x && pending.y == y &&
+            pending.width == width && pending.height == height) {
+          upload = *it;
+          uploads.erase(it);
+          break;
+        }
+      }
+      if (!upload) {
+        upload = std::make_shared<DirectUpload>();
+        upload->x = x;
+        upload->y = y;
+        upload->width = width;
+        upload->height = height;
+      }
+      // A fresh seq puts these pixels after everything submitted before
+      // them, so the entry moves to the back of the queue
+      upload->seq = next_seq++;
+      upload->rgb = rgbData;
+      uploads.push_back(upload);
+      supersedeRegion(x, y, width, height, upload->seq);
+    }
+    wakeWriter();
+    return true;
+  }
+
+  // Caller must hold slot_mutex
+  void failUploadsLocked() {
+    for (auto &upload : uploads) {
+      upload->done = true;
+    }
+    uploads.clear();
+    upload_cv.notify_all();
+  }
+
+  bool startWriterThreads() {
+    if (writers_running) {
+      return true;
+    }
+    wake_fd = eventfd(0, EFD_CLOEXEC);
+    if (wake_fd < 0) {
+      std::cerr << "Failed to create writer eventfd: " << strerror(errno)
+                << std::endl;
+      return false;
+    }
+    writers_running = true;
+    writer_busy = true;
+    writer_thread = std::thread(&Impl::writerLoop, this);
+    refine_thread = std::thread(&Impl::refineLoop, this);
+    return true;
+  }
+
+  void stopWriterThreads() {
+    {
+      std::lock_guard<std::mutex> lock(slot_mutex);
+      if (!writers_running) {
+        return;
+      }
+      writers_running = false;
+    }
+    eventfd_write(wake_fd, 1);
+    refine_cv.notify_all();
+    drained_cv.notify_all();
+    if (writer_thread.joinable()) {
+      writer_thread.join();
+    }
+    if (refine_thread.joinable()) {
+      refine_thread.join();
+    }
+    {
+      std::lock_guard<std::mutex> lock(slot_mutex);
+      failUploadsLocked();
+    }
+    close(wake_fd);
+    wake_fd = -1;
+  }
+
+  void writerLoop() {
+    // Front buffers: the newest image taken from each slot, owned by the
+    // writer alone
+    std::array<std::unique_ptr<StagedImage>, SLOT_COUNT> front;
+
+    while (writers_running) {
+      // Take the newest images right before sending - anything published
+      // while the previous upload was in flight has replaced older frames
+      for (int i = 0; i < SLOT_COUNT; i++) {
+        if (StagedImage *image = slots[i].back.exchange(nullptr)) {
+          if (front[i]) {
+            recycle(i, front[i].release());
+          }
+          front[i].reset(image);
+        }
+      }
+
+      // Oldest submission first so overlapping paints land in order
+      int slotIndex = -1;
+      for (int i = 0; i < SLOT_COUNT; i++) {
+        if (front[i] &&
+            (slotIndex < 0 || front[i]->seq < front[slotIndex]->seq)) {
+          slotIndex = i;
+        }
+      }
+
+      const uint64_t oldest = slotIndex < 0
+                                  ? std::numeric_limits<uint64_t>::max()
+                                  : front[slotIndex]->seq;
+      if (sendUpload(oldest)) {
+        continue;
+      }
+
+      if (slotIndex < 0) {
+        waitForWork();
+        continue;
+      }
+
+      std::unique_ptr<StagedImage> image = std::move(front[slotIndex]);
+      sendPixels(slotIndex, image);
+      if (image) {
+        recycle(slotIndex, image.release());
+      }
+    }
+  }
+
+  // Writer is idle: let drain waiters go, then sleep until a submit or a
+  // direct upload
+  void waitForWork() {
+    {
+      std::lock_guard<std::mutex> lock(slot_mutex);
+      writer_busy = false;
+    }
+    drained_cv.notify_all();
+
+    // A submit that saw the flag still set didn't post a wakeup, so look
+    // again after clearing it
+    wake_posted = false;
+    bool idle;
+    {
+      std::lock_guard<std::mutex> lock(slot_mutex);
+      idle = uploads.empty() && !hasStaged() && writers_running;
+    }
+    if (idle) {
+      eventfd_t value;
+      eventfd_read(wake_fd, &value);
+    }
+    writer_busy = true;
+  }
+
+  // Caller must hold slot_mutex
+  bool drained() const {
+    return !writer_busy && uploads.empty() && !hasStaged();
+  }
+
+  // Caller must hold frame_mutex
+  void startFrameThread() {
+    if (frame_running) {
+      return;
+    }
+    frame_running = true;
+    frame_thread = std::thread(&Impl::frameLoop, this);
+  }
+
+  void stopFrameThread() {
+    {
+      std::lock_guard<std::mutex> lock(frame_mutex);
+      frame_running = false;
+    }
+    frame_cv.notify_all();
+    {
+      // Pairs with the drained wait so the wakeup can't slip in between
+      // its predicate check and the wait itself
+      std::lock_guard<std::mutex> lock(slot_mutex);
+    }
+    drained_cv.notify_all();
+    if (frame_thread.joinable()) {
+      frame_thread.join();
+    }
+  }
+
+  void frameLoop() {
+    uint64_t frame = 0;
+    uint64_t avg_frame_bytes = 0;
+
+    std::unique_lock<std::mutex> lock(frame_mutex);
+    while (frame_running) {
+      if (!frame_callback) {
+        frame_cv.wait(lock);
+        continue;
+      }
+
+      std::shared_ptr<FrameCallback> callback = frame_callback;
+      in_callback = true;
+      lock.unlock();
+
+      // The next frame gets as long as the link needs to carry a typical
+      // frame, and as many bytes as the link carries in that time
+      const auto start = std::chrono::steady_clock::now();
+      const uint64_t throughput = std::max<uint64_t>(link_bytes_per_sec, 1);
+      auto interval = std::chrono::microseconds(avg_frame_bytes * 1000000 /
+                                                throughput);
+      interval = std::max(interval, MIN_FRAME_INTERVAL);
+      interval = std::min(interval, MAX_FRAME_INTERVAL);
+
+      FrameBudget budget;
+      budget.frame = frame++;
+      budget.time = interval;
+      budget.bytes = throughput * interval.count() / 1000000;
+
+      const uint64_t sent_before = bytes_sent;
+      (*callback)(budget);
+
+      // Let onFrame callers waiting to replace this callback go. Drop our
+      // reference first so a callback they replaced dies before they return.
+      callback.reset();
+      {
+        std::lock_guard<std::mutex> frame_lock(frame_mutex);
+        in_callback = false;
+      }
+      frame_cv.notify_all();
+
+      // Everything submitted this frame must be on the wire before the
+      // app is asked for another one
+      {
+        std::unique_lock<std::mutex> slot_lock(slot_mutex);
+        drained_cv.wait(slot_lock, [this]() {
+          return drained() || !writers_running || !frame_running;
+        });
+      }
+
+      avg_frame_bytes = (avg_frame_bytes * 3 + (bytes_sent - sent_before)) / 4;
+
+      lock.lock();
+      frame_cv.wait_until(lock, start + interval,
+                          [this]() { return !frame_running; });
+    }
+  }
+
+  // Anyone may drop to SCHED_IDLE, but getting back needs CAP_SYS_NICE or
+  // a permissive RLIMIT_NICE. Try the round trip on a throwaway thread so
+  // the refiner is never stranded at idle priority; without the rights it
+  // encodes at normal priority, still only once the link has gone quiet.
+  static bool canLeaveIdlePriority() {
+    bool ok = false;
+    std::thread probe([&ok]() {
+      int policy;
+      sched_param normal{};
+      sched_param idle{};
+      ok = pthread_getschedparam(pthread_self(), &policy, &normal) == 0 &&
+           pthread_setschedparam(pthread_self(), SCHED_IDLE, &idle) == 0 &&
+           pthread_setschedparam(pthread_self(), policy, &normal) == 0;
+    });
+    probe.join();
+    return ok;
+  }
+
+  // Encodes full-quality versions of progressive previews and queues them
+  // for the writer. Only the encode itself runs at idle priority: the
+  // thread is back at its normal priority whenever it holds slot_mutex, so
+  // a starved refiner can't hold up interactive uploads.
+  void refineLoop() {
+    int policy;
+    sched_param normal{};
+    pthread_getschedparam(pthread_self(), &policy, &normal);
+    const bool idle_encode = canLeaveIdlePriority();
+
+    std::unique_lock<std::mutex> lock(slot_mutex);
+    while (writers_running) {
+      int keyIndex = -1;
+      for (int i = 0; i < SLOT_COUNT; i++) {
+        auto &refine = slots[i].refine;
+        if (refine && !isCurrent(i, refine->seq)) {
+          // Replaced since its preview went out
+          recycle(i, refine.release());
+        } else if (keyIndex < 0 && refine) {
+          keyIndex = i;
+        }
+      }
+
+      if (keyIndex < 0) {
+        refine_cv.wait(lock);
+        continue;
+      }
+
+      // Wait for the link to go quiet before spending bandwidth on quality
+      const auto idle = std::chrono::nanoseconds(steadyNowNs() - last_write_ns);
+      if (writer_busy || !uploads.empty() || hasStaged() ||
+          idle < REFINE_IDLE_DELAY) {
+        refine_cv.wait_for(lock, REFINE_IDLE_DELAY);
+        continue;
+      }
+
+      std::unique_ptr<StagedImage> image = std::move(slots[keyIndex].refine);
+      lock.unlock();
+
+      // Refinement is pure polish - only spend CPU time nobody else wants
+      if (idle_encode) {
+        sched_param idle{};
+        pthread_setschedparam(pthread_self(), SCHED_IDLE, &idle);
+      }
+
+      auto jpeg = JpegEncoder::encodeRgb(image->data.data(), LCD_SIZE,
+                                         LCD_SIZE, FULL_JPEG_QUALITY);
+      std::shared_ptr<DirectUpload> upload;
+      if (!jpeg.empty()) {
+        upload = std::make_shared<DirectUpload>();
+        upload->packets = generateImagePackets(keyIndex, jpeg);
+        upload->priority = WritePriority::BULK;
+        upload->refine_key = keyIndex;
+        upload->refine_seq = image->seq;
+      }
+      recycle(keyIndex, image.release());
+
+      if (idle_encode) {
+        pthread_setschedparam(pthread_self(), policy, &normal);
+      }
+
+      lock.lock();
+      if (upload && writers_running) {
+        // Nobody waits for it; the writer checks again that the key
+        // hasn't changed before sending
+        upload->seq = next_seq++;
+        uploads.push_back(upload);
+        wakeWriter();
+      }
+    }
+  }
+
+  // Decode a GIF once at screen size and slice every frame into key tiles,
+  // encoding only the tiles that differ from the previous frame
+  bool buildGridAnimation(const std::vector<uint8_t> &gifData,
+                          GridAnimation &anim) {
+    constexpr size_t TILE_BYTES = LCD_SIZE * LCD_SIZE * 3;
+    constexpr int PITCH = LCD_SIZE + MXKeypadDevice::GAP_SIZE;
+    const int width = MXKeypadDevice::SCREEN_WIDTH;
+
+    std::array<std::vector<uint8_t>, 9> first;
+    std::array<std::vector<uint8_t>, 9> previous;
+    std::vector<uint8_t> tile(TILE_BYTES);
+
+    bool decoded = GifDecoder::decodeGifFrames(
+        gifData, MXKeypadDevice::SCREEN_WIDTH, MXKeypadDevice::SCREEN_HEIGHT,
+        [&](const uint8_t *rgba, int delay_ms) {
+          const bool is_first = anim.frames.empty();
+          GridFrame frame;
+          frame.delay_ms = delay_ms;
+
+          for (int keyIndex = 0; keyIndex < 9; keyIndex++) {
+            // Slice this key's tile out of the frame, skipping the gaps
+            const int x0 = (keyIndex % 3) * PITCH;
+            const int y0 = (keyIndex / 3) * PITCH;
+            uint8_t *dst = tile.data();
+            for (size_t y = 0; y < LCD_SIZE; y++) {
+              const uint8_t *src = rgba + ((y0 + y) * width + x0) * 4;
+              for (size_t x = 0; x < LCD_SIZE; x++) {
+                *dst++ = src[x * 4 + 0];
+                *dst++ = src[x * 4 + 1];
+                *dst++ = src[x * 4 + 2];
+              }
+            }
+
+            if (is_first) {
+              anim.first_tiles[keyIndex] = JpegEncoder::encodeRgb(
+                  tile.data(), LCD_SIZE, LCD_SIZE, FULL_JPEG_QUALITY);
+              first[keyIndex] = tile;
+              previous[keyIndex] = tile;
+            } else if (memcmp(tile.data(), previous[keyIndex].data(),
+                              TILE_BYTES) != 0) {
+              frame.tiles[keyIndex] = JpegEncoder::encodeRgb(
+                  tile.data(), LCD_SIZE, LCD_SIZE, FULL_JPEG_QUALITY);
+              previous[keyIndex].swap(tile);
+            }
+          }
+
+          anim.frames.push_back(std::move(frame));
+        });
+
+    if (!decoded || anim.frames.empty()) {
+      return false;
+    }
+
+    // Looping back to the first frame only needs the tiles that differ
+    // from the last one
+    for (int keyIndex = 0; keyIndex < 9; keyIndex++) {
+      if (memcmp(first[keyIndex].data(), previous[keyIndex].data(),
+                 TILE_BYTES) != 0) {
+        anim.frames[0].tiles[keyIndex] = anim.first_tiles[keyIndex];
+      }
+    }
+
+    return true;
+  }
+
   std::string findHidrawPath(const std::string &event_path) {
     // Extract event number from path like /dev/input/event5
     std::string event_name =
@@ -303,6 +1176,11 @@ MXKeypadDevice::MXKeypadDevice(const DeviceInfo &info)
 MXKeypadDevice::~MXKeypadDevice() {
   stopAllAnimations();
   stopMonitoring();
+  impl_->stopFrameThread();
+  impl_->stopWriterThreads();
+  if (impl_->bus) {
+    impl_->bus->removeClient(impl_->bus_client);
+  }
   if (impl_->hidraw_fd >= 0) {
     close(impl_->hidraw_fd);
   }
@@ -317,8 +1195,10 @@ void MXKeypadDevice::setEventCallback(EventCallback callback) {
   event_callback_ = callback;
 }
 
+void MXKeypadDevice::setEventSink(EventSinkPtr sink) { event_sink_ = sink; }
+
 void MXKeypadDevice::startMonitoring() {
-  if (impl_->monitoring || !event_callback_) {
+  if (impl_->monitoring || (!event_callback_ && !event_sink_)) {
     return;
   }
 
@@ -342,15 +1222,34 @@ void MXKeypadDevice::startMonitoring() {
     pfd.fd = fd;
     pfd.events = POLLIN;
 
+    // Events posted to the sink since the last flush. While set, poll
+    // without waiting so the sink is flushed as soon as input drains,
+    // batching reports that arrive back to back.
+    bool sink_pending = false;
+
+    auto emit = [this, &sink_pending](const EventPtr &event) {
+      if (event_sink_) {
+        event_sink_->post(info_.type, *event);
+        sink_pending = true;
+      }
+      if (event_callback_) {
+        event_callback_(event);
+      }
+    };
+
     while (impl_->monitoring) {
       // Wait for data with 100ms timeout (same as dialpad)
-      int ret = poll(&pfd, 1, 100);
+      int ret = poll(&pfd, 1, sink_pending ? 0 : 100);
 
       if (ret < 0) {
         break; // Error
       }
 
       if (ret == 0) {
+        if (sink_pending) {
+          event_sink_->flush();
+          sink_pending = false;
+        }
         continue; // Timeout, check if still monitoring
       }
 
@@ -383,9 +1282,7 @@ void MXKeypadDevice::startMonitoring() {
                   std::chrono::steady_clock::now().time_since_epoch())
                   .count();
 
-          if (event_callback_) {
-            event_callback_(event);
-          }
+          emit(event);
         } else if (report[4] == 0x00 && impl_->last_p_button != 0) {
           // Button release - emit event for the last pressed P button
           auto event = std::make_shared<ButtonEvent>();
@@ -397,9 +1294,7 @@ void MXKeypadDevice::startMonitoring() {
                   std::chrono::steady_clock::now().time_since_epoch())
                   .count();
 
-          if (event_callback_) {
-            event_callback_(event);
-          }
+          emit(event);
 
           impl_->last_p_button = 0; // Clear tracking
         }
@@ -442,9 +1337,7 @@ void MXKeypadDevice::startMonitoring() {
                       std::chrono::steady_clock::now().time_since_epoch())
                       .count();
 
-              if (event_callback_) {
-                event_callback_(event);
-              }
+              emit(event);
             }
           }
 
@@ -466,9 +1359,7 @@ void MXKeypadDevice::startMonitoring() {
                     std::chrono::steady_clock::now().time_since_epoch())
                     .count();
 
-            if (event_callback_) {
-              event_callback_(event);
-            }
+            emit(event);
           }
 
           // Update tracked state
@@ -481,6 +1372,10 @@ void MXKeypadDevice::startMonitoring() {
       }
     }
 
+    if (sink_pending) {
+      event_sink_->flush();
+    }
+
     close(fd);
     impl_->monitoring = false;
   });
@@ -522,6 +1417,18 @@ bool MXKeypadDevice::initialize() {
     usleep(10000);
   }
 
+  // Share LCD bandwidth fairly with other keypads on the same USB bus
+  impl_->bus = UsbBusScheduler::forHidraw(impl_->hidraw_path);
+  impl_->bus_client = impl_->bus->addClient(impl_->bus_weight);
+
+  if (!impl_->startWriterThreads()) {
+    impl_->bus->removeClient(impl_->bus_client);
+    impl_->bus.reset();
+    close(impl_->hidraw_fd);
+    impl_->hidraw_fd = -1;
+    return false;
+  }
+
   impl_->initialized = true;
   return true;
 }
@@ -532,42 +1439,126 @@ bool MXKeypadDevice::setKeyImage(int keyIndex,
     return false;
   }
 
-  auto packets = impl_->generateImagePackets(keyIndex, jpegData);
+  return impl_->uploadKeyImage(keyIndex, jpegData, WritePriority::INTERACTIVE);
+}
 
+bool MXKeypadDevice::setKeyPixels(int keyIndex,
+                                  const std::vector<uint8_t> &rgbData) {
+  if (keyIndex < 0 || keyIndex > 8 || !impl_->initialized ||
+      rgbData.size() != LCD_SIZE * LCD_SIZE * 3) {
+    return false;
+  }
+
+  // Encode on the caller's thread, then send through the writer like any
+  // other direct upload so pending submissions and refinements stay
+  // consistent
+  auto image = impl_->takeBuffer(keyIndex);
+  image->data.assign(rgbData.begin(), rgbData.end());
+  image->encoded = false;
+
+  bool progressive;
+  auto packets = impl_->encodeStaged(keyIndex, *image, progressive);
   if (packets.empty()) {
+    impl_->recycle(keyIndex, image.release());
     return false;
   }
 
-  // Uber-optimized: Pre-build iovec array inline to avoid allocation
-  const size_t packet_count = packets.size();
-  std::vector<iovec> iov(packet_count);
+  const bool ok = impl_->queueUpload(
+      std::move(packets), WritePriority::INTERACTIVE, [&](uint64_t seq) {
+        image->seq = seq;
+        impl_->cover(keyIndex, seq);
+      });
+  if (ok && progressive) {
+    impl_->queueRefinement(keyIndex, image);
+  }
+  if (image) {
+    impl_->recycle(keyIndex, image.release());
+  }
+  return ok;
+}
 
-  // Vectorized iovec construction - loop unrolled for performance
-  for (size_t i = 0; i < packet_count; ++i) {
-    iov[i] = {const_cast<uint8_t*>(packets[i].data()), packets[i].size()};
+bool MXKeypadDevice::submitKeyPixels(int keyIndex,
+                                     const std::vector<uint8_t> &rgbData) {
+  if (keyIndex < 0 || keyIndex > 8 || !impl_->initialized ||
+      rgbData.size() != LCD_SIZE * LCD_SIZE * 3) {
+    return false;
   }
 
-  // Uber-optimization: Non-blocking I/O with immediate completion check
-  const int flags = fcntl(impl_->hidraw_fd, F_GETFL, 0);
-  fcntl(impl_->hidraw_fd, F_SETFL, flags | O_NONBLOCK);
+  impl_->submit(keyIndex, rgbData, false);
+  return true;
+}
+
+bool MXKeypadDevice::submitRawPixels(uint16_t x, uint16_t y, uint16_t width,
+                                     uint16_t height,
+                                     const std::vector<uint8_t> &rgbData) {
+  if (!impl_->initialized || width == 0 || height == 0 ||
+      rgbData.size() != static_cast<size_t>(width) * height * 3) {
+    return false;
+  }
 
-  ssize_t totalWritten = writev(impl_->hidraw_fd, iov.data(), packet_count);
+  return impl_->submitRegion(x, y, width, height, rgbData);
+}
 
-  // Restore blocking mode
-  fcntl(impl_->hidraw_fd, F_SETFL, flags);
+bool MXKeypadDevice::submitKeyImage(int keyIndex,
+                                    const std::vector<uint8_t> &jpegData) {
+  if (keyIndex < 0 || keyIndex > 8 || !impl_->initialized ||
+      jpegData.empty()) {
+    return false;
+  }
 
-  if (totalWritten < 0) {
-    // If non-blocking would block, fall back to blocking write
-    if (errno == EAGAIN || errno == EWOULDBLOCK) {
-      totalWritten = writev(impl_->hidraw_fd, iov.data(), packet_count);
-    } else {
-      return false;
+  impl_->submit(keyIndex, jpegData, true);
+  return true;
+}
+
+bool MXKeypadDevice::submitScreenPixels(const std::vector<uint8_t> &rgbData) {
+  if (!impl_->initialized ||
+      rgbData.size() != SCREEN_WIDTH * SCREEN_HEIGHT * 3) {
+    return false;
+  }
+
+  impl_->submit(SCREEN_SLOT, rgbData, false);
+  return true;
+}
+
+void MXKeypadDevice::setUploadMode(UploadMode mode) {
+  impl_->upload_mode = mode;
+}
+
+UploadMode MXKeypadDevice::getUploadMode() const {
+  return impl_->upload_mode;
+}
+
+void MXKeypadDevice::setBandwidthWeight(unsigned weight) {
+  impl_->bus_weight = std::max(weight, 1u);
+  if (impl_->bus) {
+    impl_->bus->setWeight(impl_->bus_client, impl_->bus_weight);
+  }
+}
+
+bool MXKeypadDevice::onFrame(FrameCallback callback) {
+  if (!impl_->initialized) {
+    return false;
+  }
+
+  std::shared_ptr<FrameCallback> previous;
+  {
+    std::unique_lock<std::mutex> lock(impl_->frame_mutex);
+    previous = std::move(impl_->frame_callback);
+    impl_->frame_callback =
+        callback ? std::make_shared<FrameCallback>(std::move(callback))
+                 : nullptr;
+    impl_->startFrameThread();
+
+    // The old callback may still be running; wait it out so the caller
+    // can free whatever it uses. A callback replacing itself can't wait
+    // for itself to return.
+    if (std::this_thread::get_id() != impl_->frame_thread.get_id()) {
+      impl_->frame_cv.wait(lock, [this]() { return !impl_->in_callback; });
     }
   }
+  impl_->frame_cv.notify_all();
 
-  // Uber-optimization: Pre-calculated total size to avoid loop overhead
-  const ssize_t expectedTotal = packet_count * MAX_PACKET_SIZE;
-  return totalWritten == expectedTotal;
+  return true;
 }
 
 bool MXKeypadDevice::setKeyColor(int keyIndex, uint8_t r, uint8_t g,
@@ -595,39 +1586,8 @@ bool MXKeypadDevice::setRawImage(uint16_t x, uint16_t y, uint16_t width, uint16_
     return false;
   }
 
-  auto packets = impl_->generateRawImagePackets(x, y, width, height, jpegData);
-
-  if (packets.empty()) {
-    return false;
-  }
-
-  // Use vectored I/O for efficient batch write
-  const size_t packet_count = packets.size();
-  std::vector<iovec> iov(packet_count);
-
-  for (size_t i = 0; i < packet_count; ++i) {
-    iov[i] = {const_cast<uint8_t*>(packets[i].data()), packets[i].size()};
-  }
-
-  // Non-blocking I/O with fallback
-  const int flags = fcntl(impl_->hidraw_fd, F_GETFL, 0);
-  fcntl(impl_->hidraw_fd, F_SETFL, flags | O_NONBLOCK);
-
-  ssize_t totalWritten = writev(impl_->hidraw_fd, iov.data(), packet_count);
-
-  // Restore blocking mode
-  fcntl(impl_->hidraw_fd, F_SETFL, flags);
-
-  if (totalWritten < 0) {
-    if (errno == EAGAIN || errno == EWOULDBLOCK) {
-      totalWritten = writev(impl_->hidraw_fd, iov.data(), packet_count);
-    } else {
-      return false;
-    }
-  }
-
-  const ssize_t expectedTotal = packet_count * MAX_PACKET_SIZE;
-  return totalWritten == expectedTotal;
+  return impl_->uploadRawImage(x, y, width, height, jpegData,
+                               WritePriority::INTERACTIVE);
 }
 
 bool MXKeypadDevice::setKeyGif(int keyIndex,
@@ -636,8 +1596,10 @@ bool MXKeypadDevice::setKeyGif(int keyIndex,
     return false;
   }
 
-  // Stop existing animation on this key
+  // Stop existing animation on this key, and a grid animation that would
+  // keep painting over it
   stopKeyAnimation(keyIndex);
+  stopGridAnimation();
 
   // Decode GIF
   auto anim = std::make_unique<KeyAnimation>();
@@ -661,8 +1623,9 @@ bool MXKeypadDevice::setKeyGif(int keyIndex,
       const GifFrame &frame =
           anim_ptr->animation.frames[anim_ptr->current_frame];
 
-      // Display this frame
-      setKeyImage(keyIndex, frame.jpeg_data);
+      // Display this frame (bulk, so it never holds up interactive
+      // updates on other devices)
+      impl_->uploadKeyImage(keyIndex, frame.jpeg_data, WritePriority::BULK);
 
       // Wait for frame delay
       std::this_thread::sleep_for(std::chrono::milliseconds(frame.delay_ms));
@@ -692,8 +1655,10 @@ bool MXKeypadDevice::setKeyGifFromFile(int keyIndex, const std::string &gifPath,
     return false;
   }
 
-  // Stop existing animation on this key
+  // Stop existing animation on this key, and a grid animation that would
+  // keep painting over it
   stopKeyAnimation(keyIndex);
+  stopGridAnimation();
 
   // Decode GIF from file
   auto anim = std::make_unique<KeyAnimation>();
@@ -718,8 +1683,9 @@ bool MXKeypadDevice::setKeyGifFromFile(int keyIndex, const std::string &gifPath,
       const GifFrame &frame =
           anim_ptr->animation.frames[anim_ptr->current_frame];
 
-      // Display this frame
-      setKeyImage(keyIndex, frame.jpeg_data);
+      // Display this frame (bulk, so it never holds up interactive
+      // updates on other devices)
+      impl_->uploadKeyImage(keyIndex, frame.jpeg_data, WritePriority::BULK);
 
       // Wait for frame delay
       std::this_thread::sleep_for(std::chrono::milliseconds(frame.delay_ms));
@@ -755,8 +1721,9 @@ void MXKeypadDevice::stopKeyAnimation(int keyIndex) {
 }
 
 void MXKeypadDevice::stopAllAnimations() {
-  // Stop screen animation first
+  // Stop screen and grid animations first
   stopScreenAnimation();
+  stopGridAnimation();
   
   // Stop all key animations
   for (auto &pair : impl_->animations) {
@@ -773,8 +1740,9 @@ bool MXKeypadDevice::setScreenGif(const std::vector<uint8_t> &gifData, bool loop
     return false;
   }
 
-  // Stop existing screen animation
+  // Stop existing screen or grid animation
   stopScreenAnimation();
+  stopGridAnimation();
 
   // Decode GIF at full screen size (434x434)
   auto anim = std::make_unique<KeyAnimation>();
@@ -797,7 +1765,8 @@ bool MXKeypadDevice::setScreenGif(const std::vector<uint8_t> &gifData, bool loop
       const GifFrame &frame = anim_ptr->animation.frames[anim_ptr->current_frame];
 
       // Display frame on full screen (much faster than 9 individual keys!)
-      setScreenImage(frame.jpeg_data);
+      impl_->uploadRawImage(23, 6, SCREEN_WIDTH, SCREEN_HEIGHT,
+                            frame.jpeg_data, WritePriority::BULK);
 
       // Wait for frame delay
       std::this_thread::sleep_for(std::chrono::milliseconds(frame.delay_ms));
@@ -826,8 +1795,9 @@ bool MXKeypadDevice::setScreenGifFromFile(const std::string &gifPath, bool loop)
     return false;
   }
 
-  // Stop existing screen animation
+  // Stop existing screen or grid animation
   stopScreenAnimation();
+  stopGridAnimation();
 
   // Decode GIF from file at full screen size (434x434)
   auto anim = std::make_unique<KeyAnimation>();
@@ -850,7 +1820,8 @@ bool MXKeypadDevice::setScreenGifFromFile(const std::string &gifPath, bool loop)
       const GifFrame &frame = anim_ptr->animation.frames[anim_ptr->current_frame];
 
       // Display frame on full screen (much faster than 9 individual keys!)
-      setScreenImage(frame.jpeg_data);
+      impl_->uploadRawImage(23, 6, SCREEN_WIDTH, SCREEN_HEIGHT,
+                            frame.jpeg_data, WritePriority::BULK);
 
       // Wait for frame delay
       std::this_thread::sleep_for(std::chrono::milliseconds(frame.delay_ms));
@@ -884,4 +1855,95 @@ void MXKeypadDevice::stopScreenAnimation() {
   }
 }
 
+bool MXKeypadDevice::setGridGif(const std::vector<uint8_t> &gifData,
+                                bool loop) {
+  if (!impl_->initialized) {
+    return false;
+  }
+
+  // The grid animation owns every key
+  stopAllAnimations();
+
+  auto anim = std::make_unique<GridAnimation>();
+  anim->loop = loop;
+
+  if (!impl_->buildGridAnimation(gifData, *anim)) {
+    return false;
+  }
+
+  // Start animation thread
+  anim->running = true;
+
+  anim->animation_thread = std::thread([this, anim_ptr = anim.get()]() {
+    size_t current_frame = 0;
+    bool first_pass = true;
+    auto next_frame = std::chrono::steady_clock::now();
+
+    while (anim_ptr->running) {
+      const GridFrame &frame = anim_ptr->frames[current_frame];
+      const auto &tiles = (first_pass && current_frame == 0)
+                              ? anim_ptr->first_tiles
+                              : frame.tiles;
+
+      // Only tiles that changed go over the wire
+      for (int keyIndex = 0; keyIndex < 9 && anim_ptr->running; keyIndex++) {
+        if (!tiles[keyIndex].empty()) {
+          impl_->uploadKeyImage(keyIndex, tiles[keyIndex],
+                                WritePriority::BULK);
+        }
+      }
+
+      // Wait for frame delay, counted from when this frame was due so
+      // upload time doesn't stretch the animation
+      next_frame += std::chrono::milliseconds(frame.delay_ms);
+      const auto now = std::chrono::steady_clock::now();
+      if (next_frame < now) {
+        next_frame = now;
+      }
+      std::this_thread::sleep_until(next_frame);
+
+      // Next frame
+      current_frame++;
+
+      if (current_frame >= anim_ptr->frames.size()) {
+        if (anim_ptr->loop) {
+          current_frame = 0;
+          first_pass = false;
+        } else {
+          anim_ptr->running = false;
+        }
+      }
+    }
+  });
+
+  // Store animation
+  impl_->grid_animation = std::move(anim);
+
+  return true;
+}
+
+bool MXKeypadDevice::setGridGifFromFile(const std::string &gifPath,
+                                        bool loop) {
+  if (!impl_->initialized) {
+    return false;
+  }
+
+  std::vector<uint8_t> gifData;
+  if (!GifDecoder::readFile(gifPath, gifData)) {
+    return false;
+  }
+
+  return setGridGif(gifData, loop);
+}
+
+void MXKeypadDevice::stopGridAnimation() {
+  if (impl_->grid_animation) {
+    impl_->grid_animation->running = false;
+    if (impl_->grid_animation->animation_thread.joinable()) {
+      impl_->grid_animation->animation_thread.join();
+    }
+    impl_->grid_animation.reset();
+  }
+}
+
 } // namespace LogiLinux
@@ -2,12 +2,29 @@
 #define LOGILINUX_MX_KEYPAD_DEVICE_H
 
 #include "logilinux/device.h"
+#include <chrono>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <vector>
 
 namespace LogiLinux {
 
+// How pixel uploads (setKeyPixels) are encoded and sent
+enum class UploadMode {
+  FULL_QUALITY, // Encode once at full quality and send
+  PROGRESSIVE,  // Send a single-packet preview now, full quality when idle
+};
+
+// What the next frame may use, derived from measured LCD link throughput
+struct FrameBudget {
+  uint64_t frame;               // Frame counter
+  std::chrono::microseconds time; // Time until the next tick
+  size_t bytes;                 // Bytes the link can carry in that time
+};
+
+using FrameCallback = std::function<void(const FrameBudget &)>;
+
 class MXKeypadDevice : public Device {
 public:
   explicit MXKeypadDevice(const DeviceInfo &info);
@@ -18,6 +35,7 @@ public:
   bool hasCapability(DeviceCapability cap) const override;
 
   void setEventCallback(EventCallback callback) override;
+  void setEventSink(EventSinkPtr sink) override;
   void startMonitoring() override;
   void stopMonitoring() override;
   bool isMonitoring() const override;
@@ -37,13 +55,51 @@ public:
   bool setRawImage(uint16_t x, uint16_t y, uint16_t width, uint16_t height,
                    const std::vector<uint8_t> &jpegData);
 
+  // Raw pixel upload for a key (KEY_SIZE x KEY_SIZE, tightly packed RGB).
+  // Encoding follows the current upload mode.
+  bool setKeyPixels(int keyIndex, const std::vector<uint8_t> &rgbData);
+  void setUploadMode(UploadMode mode);
+  UploadMode getUploadMode() const;
+
+  // Lazy encode-at-send: queue raw RGB for a key or the full screen
+  // (SCREEN_WIDTH x SCREEN_HEIGHT) and return immediately. The device's
+  // writer encodes only the newest pending pixels when it is about to
+  // transmit, so frames superseded before they reach the wire cost nothing.
+  // Each target has a double-buffered staging slot updated with a lock-free
+  // pointer swap, so any number of threads may submit at any rate without
+  // locking or waiting on USB.
+  bool submitKeyPixels(int keyIndex, const std::vector<uint8_t> &rgbData);
+  bool submitScreenPixels(const std::vector<uint8_t> &rgbData);
+
+  // Lazy upload for an arbitrary screen region (width x height RGB). Each
+  // distinct region keeps at most one pending upload; newer pixels for it
+  // replace the waiting ones and are sent after everything submitted before.
+  bool submitRawPixels(uint16_t x, uint16_t y, uint16_t width,
+                       uint16_t height, const std::vector<uint8_t> &rgbData);
+
+  // Non-blocking setKeyImage: stage an encoded JPEG for the writer
+  bool submitKeyImage(int keyIndex, const std::vector<uint8_t> &jpegData);
+
+  // Relative share of USB bus bandwidth when several keypads upload at
+  // once (packets per round-robin turn, default 1). Key updates are always
+  // served before animations and streamed frames from any device.
+  void setBandwidthWeight(unsigned weight);
+
+  // Render-loop tick paced to the LCD link. The callback runs on the
+  // library's frame thread once per deliverable frame: the next tick comes
+  // only after everything submitted during this one has been sent. Pass an
+  // empty callback to stop ticking. Once onFrame returns, the previous
+  // callback will not run again (unless called from inside that callback,
+  // which then finishes its current tick).
+  bool onFrame(FrameCallback callback);
+
   // Screen dimensions
   static constexpr uint16_t SCREEN_WIDTH = 434;   // 118*3 + 40*2
   static constexpr uint16_t SCREEN_HEIGHT = 434;
   static constexpr uint16_t KEY_SIZE = 118;
   static constexpr uint16_t GAP_SIZE = 40;
 
-  // GIF support for individual keys
+  // GIF support for individual keys (stops a running grid animation)
   bool setKeyGif(int keyIndex, const std::vector<uint8_t> &gifData,
                  bool loop = true);
   bool setKeyGifFromFile(int keyIndex, const std::string &gifPath,
@@ -56,6 +112,13 @@ public:
   bool setScreenGifFromFile(const std::string &gifPath, bool loop = true);
   void stopScreenAnimation();
 
+  // One GIF spread across the 3x3 grid: decoded once at screen size,
+  // sliced into key tiles (skipping the gaps), and only the tiles that
+  // change between frames are uploaded. Stops any other animations.
+  bool setGridGif(const std::vector<uint8_t> &gifData, bool loop = true);
+  bool setGridGifFromFile(const std::string &gifPath, bool loop = true);
+  void stopGridAnimation();
+
 private:
   struct Impl;
   std::unique_ptr<Impl> impl_;
@@ -63,6 +126,7 @@ private:
   DeviceInfo info_;
   std::vector<DeviceCapability> capabilities_;
   EventCallback event_callback_;
+  EventSinkPtr event_sink_;
 };
 
 } // namespace LogiLinux
@@ -1,4 +1,5 @@
 #include "gif_decoder.h"
+#include "jpeg_encoder.h"
 #include <cstring>
 #include <fstream>
 #include <iostream>
@@ -7,10 +8,6 @@
 #include <gif_lib.h>
 #endif
 
-// We'll need libjpeg-turbo for efficient JPEG encoding
-#include <csetjmp>
-#include <jpeglib.h>
-
 namespace LogiLinux {
 
 #ifdef HAVE_GIFLIB
@@ -37,63 +34,10 @@ static int gifReadFunc(GifFileType *gif, GifByteType *buf, int count) {
   return to_read;
 }
 
-std::vector<uint8_t> GifDecoder::rgbaToJpeg(const uint8_t *rgba_data, int width,
-                                            int height, int quality) {
-  std::vector<uint8_t> jpeg_data;
-
-  struct jpeg_compress_struct cinfo;
-  struct jpeg_error_mgr jerr;
-
-  cinfo.err = jpeg_std_error(&jerr);
-  jpeg_create_compress(&cinfo);
-
-  // Write to memory
-  unsigned char *jpeg_buffer = nullptr;
-  unsigned long jpeg_size = 0;
-  jpeg_mem_dest(&cinfo, &jpeg_buffer, &jpeg_size);
-
-  cinfo.image_width = width;
-  cinfo.image_height = height;
-  cinfo.input_components = 3; // RGB
-  cinfo.in_color_space = JCS_RGB;
-
-  jpeg_set_defaults(&cinfo);
-  jpeg_set_quality(&cinfo, quality, TRUE);
-
-  jpeg_start_compress(&cinfo, TRUE);
-
-  // Convert RGBA to RGB and compress
-  std::vector<uint8_t> row_buffer(width * 3);
-
-  for (int y = 0; y < height; y++) {
-    const uint8_t *rgba_row = rgba_data + (y * width * 4);
-
-    // Strip alpha channel
-    for (int x = 0; x < width; x++) {
-      row_buffer[x * 3 + 0] = rgba_row[x * 4 + 0]; // R
-      row_buffer[x * 3 + 1] = rgba_row[x * 4 + 1]; // G
-      row_buffer[x * 3 + 2] = rgba_row[x * 4 + 2]; // B
-    }
-
-    JSAMPROW row_pointer = row_buffer.data();
-    jpeg_write_scanlines(&cinfo, &row_pointer, 1);
-  }
-
-  jpeg_finish_compress(&cinfo);
-
-  // Copy to vector
-  jpeg_data.assign(jpeg_buffer, jpeg_buffer + jpeg_size);
-
-  // Cleanup
-  free(jpeg_buffer);
-  jpeg_destroy_compress(&cinfo);
-
-  return jpeg_data;
-}
-
-bool GifDecoder::decodeGif(const std::vector<uint8_t> &gifData,
-                           GifAnimation &animation, int target_width,
-                           int target_height) {
+bool GifDecoder::decodeGifFrames(const std::vector<uint8_t> &gifData,
+                                 int target_width, int target_height,
+                                 const GifFrameCallback &callback,
+                                 int *source_width, int *source_height) {
   int error = 0;
 
   GifMemoryReader reader;
@@ -114,10 +58,13 @@ bool GifDecoder::decodeGif(const std::vector<uint8_t> &gifData,
     return false;
   }
 
-  animation.width = gif->SWidth;
-  animation.height = gif->SHeight;
-  animation.loop = true;
-  animation.frames.clear();
+  if (source_width) {
+    *source_width = gif->SWidth;
+  }
+  if (source_height) {
+    *source_height = gif->SHeight;
+  }
+  int frame_count = 0;
 
   // Allocate frame buffer (RGBA)
   std::vector<uint8_t> frame_buffer(target_width * target_height * 4, 0);
@@ -175,39 +122,41 @@ bool GifDecoder::decodeGif(const std::vector<uint8_t> &gifData,
       }
     }
 
-    // Convert frame to JPEG
-    GifFrame frame;
-    frame.jpeg_data =
-        rgbaToJpeg(frame_buffer.data(), target_width, target_height);
-    frame.delay_ms = delay_ms;
-
-    animation.frames.push_back(frame);
+    callback(frame_buffer.data(), delay_ms);
+    frame_count++;
   }
 
   DGifCloseFile(gif, &error);
 
+  return frame_count > 0;
+}
+
+bool GifDecoder::decodeGif(const std::vector<uint8_t> &gifData,
+                           GifAnimation &animation, int target_width,
+                           int target_height) {
+  animation.loop = true;
+  animation.frames.clear();
+
+  // Convert each frame to JPEG as it is decoded
+  decodeGifFrames(
+      gifData, target_width, target_height,
+      [&](const uint8_t *rgba, int delay_ms) {
+        GifFrame frame;
+        frame.jpeg_data =
+            JpegEncoder::encodeRgba(rgba, target_width, target_height);
+        frame.delay_ms = delay_ms;
+        animation.frames.push_back(std::move(frame));
+      },
+      &animation.width, &animation.height);
+
   return !animation.frames.empty();
 }
 
 bool GifDecoder::decodeGifFromFile(const std::string &path,
                                    GifAnimation &animation, int target_width,
                                    int target_height) {
-  std::ifstream file(path, std::ios::binary);
-  if (!file) {
-    std::cerr << "Failed to open file: " << path << std::endl;
-    return false;
-  }
-
-  // Read entire file
-  file.seekg(0, std::ios::end);
-  size_t size = file.tellg();
-  file.seekg(0, std::ios::beg);
-
-  std::vector<uint8_t> data(size);
-  file.read(reinterpret_cast<char *>(data.data()), size);
-
-  if (!file) {
-    std::cerr << "Failed to read file: " << path << std::endl;
+  std::vector<uint8_t> data;
+  if (!readFile(path, data)) {
     return false;
   }
 
@@ -240,15 +189,45 @@ bool GifDecoder::decodeGifFromFile(const std::string &path,
   return false;
 }
 
-std::vector<uint8_t> GifDecoder::rgbaToJpeg(const uint8_t *rgba_data, int width,
-                                            int height, int quality) {
-  (void)rgba_data;
-  (void)width;
-  (void)height;
-  (void)quality;
-  return {};
+bool GifDecoder::decodeGifFrames(const std::vector<uint8_t> &gifData,
+                                 int target_width, int target_height,
+                                 const GifFrameCallback &callback,
+                                 int *source_width, int *source_height) {
+  (void)gifData;
+  (void)target_width;
+  (void)target_height;
+  (void)callback;
+  (void)source_width;
+  (void)source_height;
+  std::cerr << "GIF support not available - giflib not found during build"
+            << std::endl;
+  return false;
 }
 
 #endif // HAVE_GIFLIB
 
+bool GifDecoder::readFile(const std::string &path,
+                          std::vector<uint8_t> &data) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    std::cerr << "Failed to open file: " << path << std::endl;
+    return false;
+  }
+
+  // Read entire file
+  file.seekg(0, std::ios::end);
+  size_t size = file.tellg();
+  file.seekg(0, std::ios::beg);
+
+  data.resize(size);
+  file.read(reinterpret_cast<char *>(data.data()), size);
+
+  if (!file) {
+    std::cerr << "Failed to read file: " << path << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
 } // namespace LogiLinux
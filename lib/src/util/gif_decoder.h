@@ -2,6 +2,7 @@
 #define LOGILINUX_GIF_DECODER_H
 
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -19,6 +20,9 @@ struct GifAnimation {
   bool loop;
 };
 
+// Receives each decoded frame as RGBA at the requested size
+using GifFrameCallback = std::function<void(const uint8_t *rgba, int delay_ms)>;
+
 class GifDecoder {
 public:
   // Load GIF from memory
@@ -31,9 +35,15 @@ public:
                                 GifAnimation &animation, int target_width = 118,
                                 int target_height = 118);
 
-private:
-  static std::vector<uint8_t> rgbaToJpeg(const uint8_t *rgba_data, int width,
-                                         int height, int quality = 85);
+  // Decode frames one at a time without keeping them, for callers that
+  // post-process raw pixels (e.g. slicing across the key grid)
+  static bool decodeGifFrames(const std::vector<uint8_t> &gifData,
+                              int target_width, int target_height,
+                              const GifFrameCallback &callback,
+                              int *source_width = nullptr,
+                              int *source_height = nullptr);
+
+  static bool readFile(const std::string &path, std::vector<uint8_t> &data);
 };
 
 } // namespace LogiLinux
@@ -0,0 +1,145 @@
+#include "jpeg_encoder.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef HAVE_LIBJPEG
+#include <jpeglib.h>
+#endif
+
+namespace LogiLinux {
+
+#ifdef HAVE_LIBJPEG
+
+static std::vector<uint8_t> encode(const uint8_t *data, int width, int height,
+                                   int components, int quality, bool fast) {
+  struct jpeg_compress_struct cinfo;
+  struct jpeg_error_mgr jerr;
+
+  cinfo.err = jpeg_std_error(&jerr);
+  jpeg_create_compress(&cinfo);
+
+  // Write to memory
+  unsigned char *jpeg_buffer = nullptr;
+  unsigned long jpeg_size = 0;
+  jpeg_mem_dest(&cinfo, &jpeg_buffer, &jpeg_size);
+
+  cinfo.image_width = width;
+  cinfo.image_height = height;
+  cinfo.input_components = 3; // RGB
+  cinfo.in_color_space = JCS_RGB;
+
+  jpeg_set_defaults(&cinfo);
+  jpeg_set_quality(&cinfo, quality, TRUE);
+  if (fast) {
+    cinfo.dct_method = JDCT_IFAST;
+  }
+
+  jpeg_start_compress(&cinfo, TRUE);
+
+  if (components == 3) {
+    // RGB rows can be handed to libjpeg directly
+    while (cinfo.next_scanline < cinfo.image_height) {
+      JSAMPROW row_pointer =
+          const_cast<uint8_t *>(data + cinfo.next_scanline * width * 3);
+      jpeg_write_scanlines(&cinfo, &row_pointer, 1);
+    }
+  } else {
+    // Strip alpha channel
+    std::vector<uint8_t> row_buffer(width * 3);
+
+    for (int y = 0; y < height; y++) {
+      const uint8_t *rgba_row = data + (y * width * 4);
+
+      for (int x = 0; x < width; x++) {
+        row_buffer[x * 3 + 0] = rgba_row[x * 4 + 0]; // R
+        row_buffer[x * 3 + 1] = rgba_row[x * 4 + 1]; // G
+        row_buffer[x * 3 + 2] = rgba_row[x * 4 + 2]; // B
+      }
+
+      JSAMPROW row_pointer = row_buffer.data();
+      jpeg_write_scanlines(&cinfo, &row_pointer, 1);
+    }
+  }
+
+  jpeg_finish_compress(&cinfo);
+
+  std::vector<uint8_t> jpeg_data(jpeg_buffer, jpeg_buffer + jpeg_size);
+
+  // Cleanup
+  free(jpeg_buffer);
+  jpeg_destroy_compress(&cinfo);
+
+  return jpeg_data;
+}
+
+std::vector<uint8_t> JpegEncoder::encodeRgb(const uint8_t *rgb_data, int width,
+                                            int height, int quality) {
+  return encode(rgb_data, width, height, 3, quality, false);
+}
+
+std::vector<uint8_t> JpegEncoder::encodeRgba(const uint8_t *rgba_data,
+                                             int width, int height,
+                                             int quality) {
+  return encode(rgba_data, width, height, 4, quality, false);
+}
+
+std::vector<uint8_t> JpegEncoder::encodeRgbToFit(const uint8_t *rgb_data,
+                                                 int width, int height,
+                                                 size_t max_bytes,
+                                                 int max_quality,
+                                                 int min_quality) {
+  // Walk quality down geometrically - a preview only needs to fit, not be
+  // the best possible fit, and each attempt costs a full encode
+  int quality = max_quality;
+  while (true) {
+    auto jpeg = encode(rgb_data, width, height, 3, quality, true);
+    if (jpeg.size() <= max_bytes) {
+      return jpeg;
+    }
+    if (quality <= min_quality) {
+      break;
+    }
+    quality = std::max(quality / 2, min_quality);
+  }
+  return {};
+}
+
+#else // !HAVE_LIBJPEG
+
+std::vector<uint8_t> JpegEncoder::encodeRgb(const uint8_t *rgb_data, int width,
+                                            int height, int quality) {
+  (void)rgb_data;
+  (void)width;
+  (void)height;
+  (void)quality;
+  return {};
+}
+
+std::vector<uint8_t> JpegEncoder::encodeRgba(const uint8_t *rgba_data,
+                                             int width, int height,
+                                             int quality) {
+  (void)rgba_data;
+  (void)width;
+  (void)height;
+  (void)quality;
+  return {};
+}
+
+std::vector<uint8_t> JpegEncoder::encodeRgbToFit(const uint8_t *rgb_data,
+                                                 int width, int height,
+                                                 size_t max_bytes,
+                                                 int max_quality,
+                                                 int min_quality) {
+  (void)rgb_data;
+  (void)width;
+  (void)height;
+  (void)max_bytes;
+  (void)max_quality;
+  (void)min_quality;
+  return {};
+}
+
+#endif // HAVE_LIBJPEG
+
+} // namespace LogiLinux
@@ -0,0 +1,33 @@
+#ifndef LOGILINUX_JPEG_ENCODER_H
+#define LOGILINUX_JPEG_ENCODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace LogiLinux {
+
+class JpegEncoder {
+public:
+  // Encode tightly packed RGB (3 bytes per pixel)
+  static std::vector<uint8_t> encodeRgb(const uint8_t *rgb_data, int width,
+                                        int height, int quality = 85);
+
+  // Encode tightly packed RGBA (4 bytes per pixel), alpha is dropped
+  static std::vector<uint8_t> encodeRgba(const uint8_t *rgba_data, int width,
+                                         int height, int quality = 85);
+
+  // Encode RGB to fit in max_bytes, starting at max_quality and halving
+  // the quality (down to min_quality) until the output fits. This is a
+  // cheap geometric search, not the best quality that fits. Returns an
+  // empty vector if even min_quality is too big.
+  static std::vector<uint8_t> encodeRgbToFit(const uint8_t *rgb_data,
+                                             int width, int height,
+                                             size_t max_bytes,
+                                             int max_quality = 40,
+                                             int min_quality = 5);
+};
+
+} // namespace LogiLinux
+
+#endif // LOGILINUX_JPEG_ENCODER_H
@@ -6,6 +6,7 @@
  * 
  * Options:
  *   --all                Set GIF on all buttons (0-8)
+ *   --grid               Spread one GIF across the whole 3x3 grid
  *   --no-loop            Don't loop animation (play once)
  *   --device PATH        Use specific device path
  *   --help               Show this help message
@@ -34,6 +35,8 @@ void printHelp(const char* progName) {
               << "Set animated GIF on MX Keypad LCD button.\n\n"
               << "Options:\n"
               << "  --all                Set GIF on all buttons (0-8)\n"
+              << "  --grid               Spread one GIF across the whole 3x3 grid\n"
+              << "                       (decoded once, only changed keys are sent)\n"
               << "  --no-loop            Don't loop animation (play once then stop)\n"
               << "  --device PATH        Use specific device path\n"
               << "  --help               Show this help message\n\n"
@@ -44,6 +47,7 @@ void printHelp(const char* progName) {
               << "  " << progName << " 0 spinner.gif          # Animate button 0\n"
               << "  " << progName << " GRID_5 loading.gif     # Animate button 5\n"
               << "  " << progName << " --all background.gif   # Animate all buttons\n"
+              << "  " << progName << " --grid background.gif  # One animation across the grid\n"
               << "  " << progName << " --no-loop 3 intro.gif  # Play once on button 3\n\n"
               << "Note: GIF will be scaled to 118x118 pixels if needed.\n"
               << "      Animation runs until interrupted with Ctrl+C.\n"
@@ -71,6 +75,7 @@ int parseButtonIndex(const std::string& button) {
 
 int main(int argc, char* argv[]) {
     bool setAll = false;
+    bool setGrid = false;
     bool loop = true;
     std::string devicePath;
     std::string buttonArg;
@@ -85,6 +90,8 @@ int main(int argc, char* argv[]) {
             return 0;
         } else if (arg == "--all") {
             setAll = true;
+        } else if (arg == "--grid") {
+            setGrid = true;
         } else if (arg == "--no-loop") {
             loop = false;
         } else if (arg == "--device") {
@@ -105,6 +112,11 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    // --all and --grid don't take a button, so a lone argument is the GIF
+    if ((setAll || setGrid) && gifPath.empty()) {
+        gifPath = buttonArg;
+    }
+
     // Validate arguments
     if (buttonArg.empty() || gifPath.empty()) {
         std::cerr << "Error: Missing required arguments" << std::endl;
@@ -113,7 +125,7 @@ int main(int argc, char* argv[]) {
     }
     
     int buttonIndex = parseButtonIndex(buttonArg);
-    if (!setAll && buttonIndex < 0) {
+    if (!setAll && !setGrid && buttonIndex < 0) {
         std::cerr << "Error: Invalid button index: " << buttonArg << std::endl;
         std::cerr << "Valid values: 0-8 or GRID_0 to GRID_8" << std::endl;
         return 1;
@@ -169,7 +181,18 @@ int main(int argc, char* argv[]) {
     }
     
     // Set GIF animation
-    if (setAll) {
+    if (setGrid) {
+        std::cout << "Loading GIF animation: " << gifPath << std::endl;
+        std::cout << "Spreading animation across the grid..." << std::endl;
+
+        if (!keypad->setGridGifFromFile(gifPath, loop)) {
+            std::cerr << "Error: Failed to set GIF on the grid" << std::endl;
+            std::cerr << "Make sure giflib and libjpeg are installed and the file is a valid GIF." << std::endl;
+            return 1;
+        }
+
+        std::cout << "Grid animation started" << std::endl;
+    } else if (setAll) {
         std::cout << "Loading GIF animation: " << gifPath << std::endl;
         std::cout << "Setting animation on all buttons..." << std::endl;
         